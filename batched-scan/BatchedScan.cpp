@@ -0,0 +1,164 @@
+#include "include/Data.h"
+#include "include/common.h"
+#include <iostream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define LOCAL_DATA_ARRAY_LENGTH 1024  // must match the value in kernels.clh
+#define ASSUMED_SUB_GROUP_SIZE 32  // only used to size the grid of the sub-group kernel
+
+int main()
+{
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+    cl_program program;
+    cl_command_queue queue;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the queue");
+
+    // create a program from kernel source code
+    const auto file_name = "kernels.clh";
+    const auto kernel_source_string = readFile(file_name);
+    const char* kernel_source = kernel_source_string.c_str();
+    program = clCreateProgramWithSource(context, 1, &kernel_source, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the program");
+    // build the program
+    clBuildProgram(program, 1, &device, NULL, NULL, NULL);
+
+    // read data
+    std::vector<int> host_data = flatten2D<int>(data);  // flatten and check if dim1 and dim2 are positive
+    const int num_rows = static_cast<int>(data.size());
+    const int row_length = static_cast<int>(data[0].size());
+    const size_t size_in_byte = host_data.size() * sizeof(decltype(host_data.at(0)));
+    assert(host_data.size() == size_t(num_rows) * row_length && "All rows must have the same length");
+
+    // create buffer(s)
+    cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    // transfer data to GPU
+    clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+    // prefer one sub-group per row when the device has sub-groups, the kernel only exists in that case
+    char extensions[4096] = {0};
+    clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, sizeof(extensions) - 1, extensions, NULL);
+    const std::string extension_string = extensions;
+    cl_kernel kernel_batched_scan = NULL;
+    bool use_sub_groups = false;
+    if (extension_string.find("cl_khr_subgroups") != std::string::npos ||
+        extension_string.find("cl_intel_subgroups") != std::string::npos)
+    {
+        kernel_batched_scan = clCreateKernel(program, "batchedScanRowsSubgroup", &err);
+        use_sub_groups = (err == CL_SUCCESS);
+    }
+    if (!use_sub_groups)
+    {
+        // one work-group per row, the row must fit in local memory
+        assert(row_length <= LOCAL_DATA_ARRAY_LENGTH && "Rows must fit in local memory without sub-groups");
+        kernel_batched_scan = clCreateKernel(program, "batchedScanRows", &err);
+        CHECK_CL_ERROR(err, "Couldn't create the batchedScanRows kernel");
+    }
+    std::cout << "Scanning " << num_rows << " rows of " << row_length << " elements with one "
+              << (use_sub_groups ? "sub-group" : "work-group") << " per row" << std::endl;
+
+    // set kernel args
+    err = clSetKernelArg(kernel_batched_scan, 0, sizeof(cl_mem), &device_data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_batched_scan, 1, sizeof(num_rows), &num_rows);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_batched_scan, 2, sizeof(row_length), &row_length);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+    // set global and local sizes (grid and block sizes)
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    size_t local_size;
+    size_t global_size;
+    if (use_sub_groups)
+    {
+        local_size = std::min<size_t>(256u, max_work_group_size);
+        const size_t rows_per_group = std::max<size_t>(1u, local_size / ASSUMED_SUB_GROUP_SIZE);
+        global_size = (num_rows + rows_per_group - 1) / rows_per_group * local_size;
+    }
+    else
+    {
+        // padded power of two the row is scanned over in local memory
+        int scan_length = 1;
+        while (scan_length < row_length)
+        {
+            scan_length *= 2;
+        }
+        err = clSetKernelArg(kernel_batched_scan, 3, sizeof(scan_length), &scan_length);
+        CHECK_CL_ERROR(err, "Couldn't set arg 4");
+        local_size = std::min<size_t>(std::min<size_t>(256u, max_work_group_size), scan_length);
+        global_size = num_rows * local_size;
+    }
+
+    // enqueue the kernel for execution, all the rows are scanned by this single launch
+    err = clEnqueueNDRangeKernel(queue, kernel_batched_scan, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the batched scan kernel");
+
+    // wait until execution of the kernel is over
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // read the kernel's output
+    clEnqueueReadBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+    // wait until data is compeletely read from device
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // Release resources
+    clReleaseMemObject(device_data);
+    clReleaseKernel(kernel_batched_scan);
+    clReleaseProgram(program);
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+
+    // write the result to disk, one row per line
+    const std::string output_file_name = "out.txt";
+    std::ofstream out(output_file_name);
+    if (out.is_open())
+    {
+        for (int row = 0; row < num_rows; ++row)
+        {
+            std::copy(host_data.cbegin() + row * row_length,
+                      host_data.cbegin() + (row + 1) * row_length,
+                      std::ostream_iterator<int>(out, " "));
+            out << "\n";
+        }
+        out.close();
+    }
+    else
+    {
+        std::cerr << "Couldn't open the output file" << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef DATA_H
+#define DATA_H
+
+#include <vector>
+
+// every row is scanned independently, all rows must have the same length
+inline std::vector<std::vector<int>> data = 
+                    {
+                        {3, 9, 8, 2, 5, 9, 7, 9, 1, 9, 0, 7, 4, 8, 3, 3, 7, 8, 8, 7, 6, 2, 3, 2, 8, 6, 0, 1, 2, 9, 0, 4, 0, 4, 7, 9, 6, 6, 6, 9},
+                        {7, 2, 5, 1, 0, 2, 7, 3, 4, 6, 4, 6, 8, 6, 9, 5, 8, 9, 6, 9, 3, 5, 0, 4, 9, 2, 5, 8, 9, 9, 1, 3, 9, 4, 4, 1, 1, 7, 7, 1},
+                        {5, 1, 6, 2, 0, 4, 6, 6, 1, 0, 9, 9, 0, 6, 9, 5, 8, 4, 8, 3, 0, 4, 0, 1, 1, 9, 8, 0, 3, 6, 4, 9, 4, 2, 0, 5, 5, 5, 2, 6},
+                        {6, 7, 8, 6, 9, 8, 1, 9, 8, 4, 6, 3, 4, 6, 4, 8, 4, 8, 5, 0, 6, 9, 5, 0, 6, 9, 9, 2, 0, 5, 7, 5, 5, 9, 4, 7, 0, 9, 0, 0},
+                        {5, 4, 7, 4, 9, 9, 5, 2, 5, 2, 5, 5, 9, 4, 4, 6, 1, 0, 9, 2, 4, 8, 3, 4, 3, 5, 2, 6, 1, 1, 9, 5, 5, 3, 7, 2, 1, 5, 3, 9},
+                        {7, 4, 3, 1, 0, 8, 3, 5, 9, 2, 4, 5, 1, 9, 5, 9, 2, 6, 4, 8, 4, 7, 5, 6, 4, 6, 9, 6, 0, 6, 2, 3, 0, 7, 9, 8, 6, 8, 3, 0},
+                        {7, 8, 4, 8, 5, 3, 1, 9, 4, 1, 3, 0, 0, 8, 3, 6, 9, 0, 0, 7, 1, 2, 8, 4, 3, 0, 8, 8, 6, 0, 9, 1, 5, 2, 4, 8, 7, 0, 5, 3},
+                        {3, 1, 8, 1, 2, 3, 4, 2, 0, 7, 9, 6, 0, 4, 3, 4, 9, 8, 8, 6, 0, 7, 5, 0, 0, 2, 0, 1, 0, 1, 7, 0, 1, 8, 8, 7, 5, 2, 5, 1}
+                    };
+
+#endif
\ No newline at end of file
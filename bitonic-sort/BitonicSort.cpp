@@ -1,20 +1,24 @@
 #include "include/Data.h"
 #include "include/common.h"
+#include "include/BitonicSort.h"
 #include <iostream>
 #include <string>
 #include <iterator>
 #include <algorithm>
+#include <random>
 // OpenCL includes
 #include <CL/cl.h>
 
-int main()
+/*
+sorts the keys of Data.h, or argv[1] random keys (any length, e.g. 30000000)
+*/
+int main(int argc, char** argv)
 {
     // initialize OpenCL
     cl_int err = CL_SUCCESS;
     cl_platform_id platform_id;
     cl_device_id device;
     cl_context context;
-    cl_program program;
     cl_command_queue queue;
 
     clGetPlatformIDs(1, &platform_id, NULL); 
@@ -38,52 +42,85 @@ int main()
     queue = clCreateCommandQueue(context, device, NULL, &err);
     CHECK_CL_ERROR(err, "Couldn't create the queue");
 
-    // create a program from kernel source code
+    // create the bitonic sort program from kernel source code
     const auto file_name = "kernels.clh";
     const auto kernel_source_string = readFile(file_name);
-    const char* kernel_source = kernel_source_string.c_str();
-    program = clCreateProgramWithSource(context, 1, &kernel_source, NULL, &err);
-    CHECK_CL_ERROR(err, "Couldn't create the program");
-    // build the program
-    clBuildProgram(program, 1, &device, NULL, NULL, NULL);
-    
+    BitonicSort bitonic_sort = createBitonicSort(context, device, kernel_source_string);
+    // same kernels, the permutation moves along with the keys
+    BitonicSort bitonic_argsort = createBitonicSort(context, device, kernel_source_string, BitonicPayload::ArgSort);
+    // the largest keys only, with their indices
+    const int max_top_k = 10;
+
     // read data
     std::vector<int> host_data = data;  // copy
+    if (argc > 1)
+    {
+        host_data.resize(std::stoul(argv[1]));
+        std::mt19937 generator(42);
+        std::generate(host_data.begin(), host_data.end(), generator);
+    }
     const size_t length = host_data.size();
     const size_t size_in_byte = length * sizeof(decltype(host_data.at(0)));
     
-    assert((length > 0) && ((length & (length-1)) == 0) && "Invalid Length: length must be positive and a power of two");
+    assert((length > 0) && "Invalid Length: length must be positive");
+
+    // the same keys cut into segments of 1 to LOCAL_DATA_ARRAY_LENGTH keys, every segment is sorted on its own
+    std::vector<int> segment_offsets;
+    std::mt19937 segment_generator(7);
+    std::uniform_int_distribution<int> segment_length(1, LOCAL_DATA_ARRAY_LENGTH);
+    for (size_t offset = 0; offset < length; offset += segment_length(segment_generator))
+    {
+        segment_offsets.push_back(static_cast<int>(offset));
+    }
+    const int num_segments = static_cast<int>(segment_offsets.size());
+    const int top_k = std::min(max_top_k, static_cast<int>(length));
+    BitonicTopK bitonic_top_k = createBitonicTopK(context, device, kernel_source_string, top_k, true);
+
     // create buffer(s)
     cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
     CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_argsort_keys = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_permutation = clCreateBuffer(context, CL_MEM_WRITE_ONLY, length * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_segmented_data = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_segment_offsets = clCreateBuffer(context, CL_MEM_READ_ONLY, num_segments * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_top_keys = clCreateBuffer(context, CL_MEM_WRITE_ONLY, top_k * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_top_indices = clCreateBuffer(context, CL_MEM_WRITE_ONLY, top_k * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
     
     // transfer data to GPU
     clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+    clEnqueueWriteBuffer(queue, device_argsort_keys, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+    clEnqueueWriteBuffer(queue, device_segmented_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+    clEnqueueWriteBuffer(queue, device_segment_offsets, CL_TRUE, 0, num_segments * sizeof(cl_int), segment_offsets.data(), 0, NULL, NULL);
 
-    // build kernel(s)
-    cl_kernel kernel_botinic_sort = clCreateKernel(program, "bitonicSort", &err);
-    CHECK_CL_ERROR(err, "Couldn't create the bitonicSort kernel");
-
-    // set kernel args
-    err = clSetKernelArg(kernel_botinic_sort, 0, sizeof(cl_mem), &device_data);
-    CHECK_CL_ERROR(err, "Couldn't set arg 1");
-    clSetKernelArg(kernel_botinic_sort, 1, sizeof(length), &length);
-    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    // the top-k selection reads the input before it's sorted in place, the in-order queue runs it first
+    enqueueBitonicTopK(queue, bitonic_top_k, device_data, static_cast<cl_int>(length), device_top_keys, device_top_indices);
+    // enqueue the tile sort and all the merge steps
+    enqueueBitonicSort(queue, bitonic_sort, device_data, static_cast<cl_int>(length));
+    enqueueBitonicSort(queue, bitonic_argsort, device_argsort_keys, static_cast<cl_int>(length), device_permutation);
+    // all the segments in one launch
+    enqueueBitonicSortSegments(queue, bitonic_sort, device_segmented_data, static_cast<cl_int>(length), device_segment_offsets, num_segments);
 
-    // set global and local sizes (grid and block sizes)
-    size_t global_size = 32u;
-    size_t local_size = 32u;
-
-    // enqueue the kernel for execution
-    err = clEnqueueNDRangeKernel(queue, kernel_botinic_sort, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
-    CHECK_CL_ERROR(err, "Couldn't launch the bitonicSort kernel");
-
-    // wait until execution of the kernel is over
+    // wait until execution of the kernels is over
     err = clFinish(queue);
     CHECK_CL_ERROR(err, "Couldn't empty the queue");
 
     // read the kernel's output
+    const std::vector<int> unsorted_data = host_data;
+    std::vector<int> permutation(length);
+    std::vector<int> segmented_data(length);
+    std::vector<int> top_keys(top_k);
+    std::vector<int> top_indices(top_k);
     clEnqueueReadBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+    clEnqueueReadBuffer(queue, device_permutation, CL_TRUE, 0, length * sizeof(cl_int), permutation.data(), 0, NULL, NULL);
+    clEnqueueReadBuffer(queue, device_segmented_data, CL_TRUE, 0, size_in_byte, segmented_data.data(), 0, NULL, NULL);
+    clEnqueueReadBuffer(queue, device_top_keys, CL_TRUE, 0, top_k * sizeof(cl_int), top_keys.data(), 0, NULL, NULL);
+    clEnqueueReadBuffer(queue, device_top_indices, CL_TRUE, 0, top_k * sizeof(cl_int), top_indices.data(), 0, NULL, NULL);
 
     // wait until data is compeletely read from device 
     err = clFinish(queue);
@@ -91,9 +128,44 @@ int main()
 
     // Release resources
     clReleaseMemObject(device_data);
-    clReleaseKernel(kernel_botinic_sort);
-    clReleaseProgram(program);
+    clReleaseMemObject(device_argsort_keys);
+    clReleaseMemObject(device_permutation);
+    clReleaseMemObject(device_segmented_data);
+    clReleaseMemObject(device_segment_offsets);
+    clReleaseMemObject(device_top_keys);
+    clReleaseMemObject(device_top_indices);
+    releaseBitonicTopK(bitonic_top_k);
+    releaseBitonicSort(bitonic_sort);
+    releaseBitonicSort(bitonic_argsort);
+    clReleaseCommandQueue(queue);
     clReleaseContext(context);
+
+    std::cout << length << " keys sorted: " << (std::is_sorted(host_data.cbegin(), host_data.cend()) ? "yes" : "no") << std::endl;
+    // the permutation gathers the unsorted keys in sorted order
+    bool permutation_sorts = true;
+    for (size_t i = 0; i < length; ++i)
+    {
+        permutation_sorts = permutation_sorts && (unsorted_data[permutation[i]] == host_data[i]);
+    }
+    std::cout << "argsort permutation sorts the keys: " << (permutation_sorts ? "yes" : "no") << std::endl;
+    // every segment holds its own keys, sorted
+    bool segments_sorted = true;
+    for (int segment = 0; segment < num_segments; ++segment)
+    {
+        const auto first = segment_offsets[segment];
+        const auto last = (segment + 1 < num_segments) ? segment_offsets[segment + 1] : static_cast<int>(length);
+        std::vector<int> expected(unsorted_data.cbegin() + first, unsorted_data.cbegin() + last);
+        std::sort(expected.begin(), expected.end());
+        segments_sorted = segments_sorted && std::equal(expected.cbegin(), expected.cend(), segmented_data.cbegin() + first);
+    }
+    std::cout << num_segments << " segments sorted: " << (segments_sorted ? "yes" : "no") << std::endl;
+    // the top keys are the last ones of the sorted keys, and their indices point at them in the input
+    bool top_k_found = true;
+    for (int i = 0; i < top_k; ++i)
+    {
+        top_k_found = top_k_found && (top_keys[i] == host_data[length - 1 - i]) && (unsorted_data[top_indices[i]] == top_keys[i]);
+    }
+    std::cout << "top " << top_k << " keys found: " << (top_k_found ? "yes" : "no") << std::endl;
     
     // write the result to disk
     const std::string output_file_name = "out.txt";
@@ -0,0 +1,380 @@
+#ifndef BITONIC_SORT_H
+#define BITONIC_SORT_H
+
+#include "common.h"
+#include <algorithm>
+#include <string>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define LOCAL_DATA_ARRAY_LENGTH 1024  // must match the value in kernels.clh
+#define BITONIC_GROUP_SIZE 256
+#define BITONIC_TOP_K_GROUPS_PER_COMPUTE_UNIT 4
+
+/*
+what moves along with the keys
+*/
+enum class BitonicPayload
+{
+    None,
+    Payload32,  // one cl_uint per key
+    Payload64,  // one cl_ulong per key
+    ArgSort     // the payload is output only and receives the sorting permutation (cl_int)
+};
+
+/*
+OpenCL C spelling of a key type and of its order, compiled into the kernels
+definitions is prepended to the kernels (e.g. the typedef of a struct key), less(a, b) is an expression of a and b
+a struct key needs a host struct with the same layout and its own specialization, for example
+    struct Point { cl_int x; cl_int y; };
+    template <> struct BitonicKeyType<Point>
+    {
+        static constexpr const char* name = "Point";
+        static constexpr const char* definitions = "typedef struct { int x; int y; } Point;";
+        static constexpr const char* less = "((a).x < (b).x || ((a).x == (b).x && (a).y < (b).y))";
+    };
+*/
+template <typename K>
+struct BitonicKeyType;
+
+template <>
+struct BitonicKeyType<cl_int>
+{
+    static constexpr const char* name = "int";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "((a) < (b))";
+};
+
+template <>
+struct BitonicKeyType<cl_uint>
+{
+    static constexpr const char* name = "uint";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "((a) < (b))";
+};
+
+template <>
+struct BitonicKeyType<cl_long>
+{
+    static constexpr const char* name = "long";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "((a) < (b))";
+};
+
+template <>
+struct BitonicKeyType<cl_ulong>
+{
+    static constexpr const char* name = "ulong";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "((a) < (b))";
+};
+
+// NaNs go after every number (before them when descending), and all NaNs are equivalent
+template <>
+struct BitonicKeyType<cl_float>
+{
+    static constexpr const char* name = "float";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "(isnan(b) ? !isnan(a) : ((a) < (b)))";
+};
+
+template <>
+struct BitonicKeyType<cl_double>
+{
+    static constexpr const char* name = "double";
+    static constexpr const char* definitions = "#pragma OPENCL EXTENSION cl_khr_fp64 : enable";
+    static constexpr const char* less = "(isnan(b) ? !isnan(a) : ((a) < (b)))";
+};
+
+/*
+the three bitonic sort kernels of one program
+*/
+struct BitonicSort
+{
+    cl_program program = NULL;
+    BitonicPayload payload = BitonicPayload::None;
+    cl_kernel kernel_sort_tiles = NULL;
+    cl_kernel kernel_merge_global = NULL;
+    cl_kernel kernel_merge_local = NULL;
+    cl_kernel kernel_sort_segments = NULL;
+    size_t local_size = 0;
+};
+
+/*
+builds kernel_source for keys of type K with the given extra build options
+*/
+template <typename K>
+cl_program buildBitonicProgram(cl_context context, cl_device_id device, const std::string& kernel_source, const std::string& options)
+{
+    // the comparator is an expression, it's prepended to the kernels rather than passed as a build option
+    const std::string key_source_string = std::string(BitonicKeyType<K>::definitions) + "\n" +
+                                          "#define KEY_LESS(a, b) (" + BitonicKeyType<K>::less + ")\n";
+    const std::string all_options = std::string("-D KEY_T=") + BitonicKeyType<K>::name + options;
+
+    cl_int err = CL_SUCCESS;
+    const char* sources[] = {key_source_string.c_str(), kernel_source.c_str()};
+    cl_program program = clCreateProgramWithSource(context, 2, sources, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the bitonic sort program");
+    err = clBuildProgram(program, 1, &device, all_options.c_str(), NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't build the bitonic sort program");
+    return program;
+}
+
+/*
+builds the bitonic sort kernels (kernel_source is the content of bitonic-sort/include/kernels.clh)
+for keys of type K, in ascending or descending order
+*/
+template <typename K = cl_int>
+BitonicSort createBitonicSort(cl_context context, cl_device_id device, const std::string& kernel_source,
+                              const BitonicPayload payload = BitonicPayload::None, const bool descending = false)
+{
+    static const char* payload_options[] = {"", " -D PAYLOAD_T=uint", " -D PAYLOAD_T=ulong", " -D ARGSORT"};
+    const std::string options = std::string(payload_options[static_cast<int>(payload)]) +
+                                (descending ? " -D SORT_DESCENDING" : "");
+
+    cl_int err = CL_SUCCESS;
+    BitonicSort sort;
+    sort.payload = payload;
+    sort.program = buildBitonicProgram<K>(context, device, kernel_source, options);
+
+    sort.kernel_sort_tiles = clCreateKernel(sort.program, "bitonicSort", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the bitonicSort kernel");
+    sort.kernel_merge_global = clCreateKernel(sort.program, "bitonicMergeGlobal", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the bitonicMergeGlobal kernel");
+    sort.kernel_merge_local = clCreateKernel(sort.program, "bitonicMergeLocal", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the bitonicMergeLocal kernel");
+    sort.kernel_sort_segments = clCreateKernel(sort.program, "bitonicSortSegments", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the bitonicSortSegments kernel");
+
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    sort.local_size = std::min<size_t>(BITONIC_GROUP_SIZE, max_work_group_size);
+
+    return sort;
+}
+
+/*
+enqueues the sort of the n keys of data in the order the sort was built for, nothing is read back
+n can be any positive length, the array is padded virtually (see kernels.clh)
+payload (n elements) moves with the keys, or receives the permutation for ArgSort, it's ignored without a payload
+*/
+void enqueueBitonicSort(cl_command_queue queue, const BitonicSort& sort, cl_mem data, const cl_int n, cl_mem payload = NULL)
+{
+    assert((n > 0) && "Invalid Length: length must be positive");
+    assert((sort.payload == BitonicPayload::None || payload != NULL) && "This sort needs a payload buffer");
+    cl_int err = CL_SUCCESS;
+
+    // length of the virtually padded array
+    cl_int padded_length = 1;
+    while (padded_length < n)
+    {
+        padded_length *= 2;
+    }
+
+    const size_t local_size = sort.local_size;
+    const size_t num_tiles = (n + LOCAL_DATA_ARRAY_LENGTH - 1) / LOCAL_DATA_ARRAY_LENGTH;
+    const size_t tiles_global_size = num_tiles * local_size;
+
+    // 1. sort every tile
+    err = clSetKernelArg(sort.kernel_sort_tiles, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_sort_tiles, 1, sizeof(cl_mem), &payload);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_sort_tiles, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clEnqueueNDRangeKernel(queue, sort.kernel_sort_tiles, 1, NULL, &tiles_global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the bitonicSort kernel");
+
+    err = clSetKernelArg(sort.kernel_merge_global, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_merge_global, 1, sizeof(cl_mem), &payload);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_merge_global, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(sort.kernel_merge_local, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_merge_local, 1, sizeof(cl_mem), &payload);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_merge_local, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+    // one work-item per pair for the global steps
+    const size_t pairs_global_size = (static_cast<size_t>(padded_length / 2) + local_size - 1) / local_size * local_size;
+
+    // 2. merge sequences longer than a tile, the in-order queue keeps the steps in order
+    for (cl_int seq_len = 2 * LOCAL_DATA_ARRAY_LENGTH; seq_len <= padded_length; seq_len *= 2)
+    {
+        // strides that span several tiles go through global memory, one launch per stride
+        for (cl_int stride = seq_len / 2; stride >= LOCAL_DATA_ARRAY_LENGTH; stride /= 2)
+        {
+            err = clSetKernelArg(sort.kernel_merge_global, 3, sizeof(seq_len), &seq_len);
+            CHECK_CL_ERROR(err, "Couldn't set arg 4");
+            err = clSetKernelArg(sort.kernel_merge_global, 4, sizeof(stride), &stride);
+            CHECK_CL_ERROR(err, "Couldn't set arg 5");
+            err = clEnqueueNDRangeKernel(queue, sort.kernel_merge_global, 1, NULL, &pairs_global_size, &local_size, 0, NULL, NULL);
+            CHECK_CL_ERROR(err, "Couldn't launch the bitonicMergeGlobal kernel");
+        }
+
+        // 3. the remaining strides fit in a tile, they all run in one launch
+        err = clSetKernelArg(sort.kernel_merge_local, 3, sizeof(seq_len), &seq_len);
+        CHECK_CL_ERROR(err, "Couldn't set arg 4");
+        err = clEnqueueNDRangeKernel(queue, sort.kernel_merge_local, 1, NULL, &tiles_global_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the bitonicMergeLocal kernel");
+    }
+}
+
+/*
+enqueues the sort of every segment of data independently, in a single launch, nothing is read back
+segment_offsets (num_segments ints on the device) holds the start of every segment, the first one is 0 and the last one ends at n
+segments must not be longer than LOCAL_DATA_ARRAY_LENGTH keys
+*/
+void enqueueBitonicSortSegments(cl_command_queue queue, const BitonicSort& sort, cl_mem data, const cl_int n,
+                                cl_mem segment_offsets, const cl_int num_segments, cl_mem payload = NULL)
+{
+    assert((num_segments > 0) && "There must be at least one segment");
+    assert((sort.payload == BitonicPayload::None || payload != NULL) && "This sort needs a payload buffer");
+
+    cl_int err = clSetKernelArg(sort.kernel_sort_segments, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_sort_segments, 1, sizeof(cl_mem), &payload);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_sort_segments, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(sort.kernel_sort_segments, 3, sizeof(cl_mem), &segment_offsets);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clSetKernelArg(sort.kernel_sort_segments, 4, sizeof(num_segments), &num_segments);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+
+    // one work-group per segment
+    const size_t local_size = sort.local_size;
+    const size_t global_size = num_segments * local_size;
+    err = clEnqueueNDRangeKernel(queue, sort.kernel_sort_segments, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the bitonicSortSegments kernel");
+}
+
+void releaseBitonicSort(BitonicSort& sort)
+{
+    clReleaseKernel(sort.kernel_sort_tiles);
+    clReleaseKernel(sort.kernel_merge_global);
+    clReleaseKernel(sort.kernel_merge_local);
+    clReleaseKernel(sort.kernel_sort_segments);
+    clReleaseProgram(sort.program);
+    sort = BitonicSort();
+}
+
+/*
+top-k selection: the k smallest (or largest) keys and their indices, without sorting the whole input
+*/
+struct BitonicTopK
+{
+    cl_program program = NULL;
+    cl_kernel kernel_top_k = NULL;
+    int k = 0;
+    size_t local_size = 0;
+    size_t num_groups = 0;
+    cl_mem candidate_keys = NULL;  // the k keys of every work-group of the first pass
+    cl_mem candidate_indices = NULL;
+};
+
+/*
+builds the top-k kernel for keys of type K (kernel_source is the content of bitonic-sort/include/kernels.clh)
+k is at most LOCAL_DATA_ARRAY_LENGTH/2, largest selects the k largest keys instead of the k smallest
+*/
+template <typename K = cl_int>
+BitonicTopK createBitonicTopK(cl_context context, cl_device_id device, const std::string& kernel_source,
+                              const int k, const bool largest = false)
+{
+    assert((k > 0 && k <= LOCAL_DATA_ARRAY_LENGTH / 2) && "k must be in [1, LOCAL_DATA_ARRAY_LENGTH/2]");
+    int k_block = 1;
+    while (k_block < k)
+    {
+        k_block *= 2;
+    }
+    const std::string options = " -D ARGSORT -D TOP_K=" + std::to_string(k) + " -D TOP_K_BLOCK=" + std::to_string(k_block) +
+                                (largest ? " -D SORT_DESCENDING" : "");
+
+    cl_int err = CL_SUCCESS;
+    BitonicTopK top_k;
+    top_k.k = k;
+    top_k.program = buildBitonicProgram<K>(context, device, kernel_source, options);
+    top_k.kernel_top_k = clCreateKernel(top_k.program, "bitonicTopK", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the bitonicTopK kernel");
+
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    top_k.local_size = std::min<size_t>(BITONIC_GROUP_SIZE, max_work_group_size);
+
+    // enough work-groups to fill the device, their candidates are selected by a single work-group
+    cl_uint compute_units;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(compute_units), &compute_units, NULL);
+    top_k.num_groups = std::max<size_t>(1u, compute_units * BITONIC_TOP_K_GROUPS_PER_COMPUTE_UNIT);
+
+    top_k.candidate_keys = clCreateBuffer(context, CL_MEM_READ_WRITE, top_k.num_groups * k * sizeof(K), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    top_k.candidate_indices = clCreateBuffer(context, CL_MEM_READ_WRITE, top_k.num_groups * k * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    return top_k;
+}
+
+/*
+enqueues the selection of the k first keys of data (n >= k keys) in the order of top_k, nothing is read back
+top_keys (k keys) receives them in order and top_indices (k ints) their positions in data, equal keys are ranked by position
+*/
+void enqueueBitonicTopK(cl_command_queue queue, const BitonicTopK& top_k, cl_mem data, const cl_int n,
+                        cl_mem top_keys, cl_mem top_indices)
+{
+    assert((n >= top_k.k) && "There must be at least k keys");
+    cl_int err = CL_SUCCESS;
+    const size_t local_size = top_k.local_size;
+
+    // every work-group needs a share of at least k keys
+    const size_t num_groups = std::min<size_t>(top_k.num_groups, n / top_k.k);
+    const size_t global_size = num_groups * local_size;
+    // with a single work-group the first pass is the only one
+    cl_mem first_pass_keys = (num_groups > 1) ? top_k.candidate_keys : top_keys;
+    cl_mem first_pass_indices = (num_groups > 1) ? top_k.candidate_indices : top_indices;
+    cl_mem no_indices = NULL;
+
+    err = clSetKernelArg(top_k.kernel_top_k, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(top_k.kernel_top_k, 1, sizeof(cl_mem), &no_indices);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(top_k.kernel_top_k, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(top_k.kernel_top_k, 3, sizeof(cl_mem), &first_pass_keys);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clSetKernelArg(top_k.kernel_top_k, 4, sizeof(cl_mem), &first_pass_indices);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+    err = clEnqueueNDRangeKernel(queue, top_k.kernel_top_k, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the bitonicTopK kernel");
+
+    if (num_groups > 1)
+    {
+        // the candidates of all the work-groups, selected by one work-group
+        const cl_int num_candidates = static_cast<cl_int>(num_groups) * top_k.k;
+        err = clSetKernelArg(top_k.kernel_top_k, 0, sizeof(cl_mem), &top_k.candidate_keys);
+        CHECK_CL_ERROR(err, "Couldn't set arg 1");
+        err = clSetKernelArg(top_k.kernel_top_k, 1, sizeof(cl_mem), &top_k.candidate_indices);
+        CHECK_CL_ERROR(err, "Couldn't set arg 2");
+        err = clSetKernelArg(top_k.kernel_top_k, 2, sizeof(num_candidates), &num_candidates);
+        CHECK_CL_ERROR(err, "Couldn't set arg 3");
+        err = clSetKernelArg(top_k.kernel_top_k, 3, sizeof(cl_mem), &top_keys);
+        CHECK_CL_ERROR(err, "Couldn't set arg 4");
+        err = clSetKernelArg(top_k.kernel_top_k, 4, sizeof(cl_mem), &top_indices);
+        CHECK_CL_ERROR(err, "Couldn't set arg 5");
+        err = clEnqueueNDRangeKernel(queue, top_k.kernel_top_k, 1, NULL, &local_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the bitonicTopK kernel");
+    }
+}
+
+void releaseBitonicTopK(BitonicTopK& top_k)
+{
+    clReleaseMemObject(top_k.candidate_keys);
+    clReleaseMemObject(top_k.candidate_indices);
+    clReleaseKernel(top_k.kernel_top_k);
+    clReleaseProgram(top_k.program);
+    top_k = BitonicTopK();
+}
+
+#endif
@@ -0,0 +1,312 @@
+#include "include/common.h"
+#include "../merge-sort/include/MergeSort.h"
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define NUM_SLOTS 2  // double buffering: one run is sorted while the other one is transferred
+#define SAMPLES_PER_RUN 64  // keys of every run that choose the splitters of the merge
+#define PREFETCH_LENGTH (1 << 18)  // keys of a run read ahead of the merge
+
+/*
+writes a test input of num_elements random ints to disk
+it is written in pieces so that it doesn't need to fit in host memory either
+*/
+void writeTestInput(const std::string& file_name, const size_t num_elements)
+{
+    std::ofstream out(file_name, std::ios::binary);
+    assert(out.is_open() && "Couldn't create the input file");
+    std::mt19937 generator(42);
+    std::vector<int> piece(1 << 20);
+    for (size_t written = 0; written < num_elements; written += piece.size())
+    {
+        const size_t piece_length = std::min(piece.size(), num_elements - written);
+        std::generate(piece.begin(), piece.begin() + piece_length, generator);
+        out.write(reinterpret_cast<const char*>(piece.data()), piece_length * sizeof(int));
+    }
+}
+
+/*
+a sorted run on disk, mapped read-only for the merge
+*/
+struct Run
+{
+    MappedFile file;
+    const int* keys = nullptr;
+    size_t length = 0;
+};
+
+/*
+merges the keys in [lower, upper) of all the runs into output, lower is ignored for the first part and upper for the last one
+equal keys are taken from the runs in order, so the merge is stable
+*/
+void mergeRunPart(const std::vector<Run>& runs, const int* lower, const int* upper, int* output)
+{
+    const size_t num_runs = runs.size();
+    std::vector<const int*> next(num_runs);
+    std::vector<const int*> end(num_runs);
+    std::vector<const int*> prefetched(num_runs);
+    for (size_t r = 0; r < num_runs; ++r)
+    {
+        const int* first = runs[r].keys;
+        const int* last = runs[r].keys + runs[r].length;
+        next[r] = lower ? std::lower_bound(first, last, *lower) : first;
+        end[r] = upper ? std::lower_bound(first, last, *upper) : last;
+        prefetched[r] = next[r];
+    }
+
+    // the smallest next key of every run, ties go to the first run
+    using HeapEntry = std::pair<int, size_t>;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    for (size_t r = 0; r < num_runs; ++r)
+    {
+        if (next[r] < end[r])
+        {
+            heap.push({*next[r], r});
+        }
+    }
+
+    while (!heap.empty())
+    {
+        const size_t r = heap.top().second;
+        *output++ = heap.top().first;
+        heap.pop();
+
+        // keep the OS reading the run ahead of the merge, so the merge rarely waits for the disk
+        if (prefetched[r] < end[r] && next[r] + PREFETCH_LENGTH / 2 >= prefetched[r])
+        {
+            const size_t offset = (prefetched[r] - runs[r].keys) * sizeof(int);
+            prefetchMappedFile(runs[r].file, offset, PREFETCH_LENGTH * sizeof(int));
+            prefetched[r] += std::min<size_t>(PREFETCH_LENGTH, end[r] - prefetched[r]);
+        }
+
+        if (++next[r] < end[r])
+        {
+            heap.push({*next[r], r});
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // input and output are binary files of ints
+    const std::string input_file_name = (argc > 1) ? argv[1] : "in.bin";
+    const std::string output_file_name = (argc > 2) ? argv[2] : "out.bin";
+    const size_t num_test_elements = size_t(1) << 26;  // only used when the input file doesn't exist
+    size_t run_length = size_t(1) << 24;  // keys per run, clamped below to what the device allows
+    const unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    // separate in-order queues so that uploads, sorts and downloads of different runs can overlap
+    cl_command_queue upload_queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the upload queue");
+    cl_command_queue compute_queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the compute queue");
+    cl_command_queue download_queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the download queue");
+
+    // the runs are sorted by the merge sort of the merge-sort project
+    const auto kernel_source_string = readFile("../../merge-sort/include/kernels.clh");
+    MergeSort merge_sort = createMergeSort(context, device, kernel_source_string);
+
+    // map the input (create a test input first if there is none)
+    MappedFile input = openMappedFile(input_file_name);
+    if (input.data == nullptr)
+    {
+        std::cout << "Writing a test input of " << num_test_elements << " elements to " << input_file_name << std::endl;
+        writeTestInput(input_file_name, num_test_elements);
+        input = openMappedFile(input_file_name);
+    }
+    assert(input.data != nullptr && "Couldn't open the input file");
+    const size_t length = input.size / sizeof(int);
+    assert((length > 0) && "Invalid Length: length must be positive");
+    const int* host_in = static_cast<const int*>(input.data);
+
+    // every slot holds a run and the scratch buffer of its sort, all of them in at most half of the device memory
+    cl_ulong max_alloc_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(max_alloc_size), &max_alloc_size, NULL);
+    cl_ulong global_mem_size;
+    clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(global_mem_size), &global_mem_size, NULL);
+    run_length = std::min<size_t>(run_length, max_alloc_size / sizeof(int));
+    run_length = std::min<size_t>(run_length, global_mem_size / 2 / (2 * NUM_SLOTS * sizeof(int)));
+    run_length = std::min(run_length, length);
+    const size_t num_runs = (length + run_length - 1) / run_length;
+
+    // create buffer(s)
+    cl_mem device_keys[NUM_SLOTS];
+    cl_mem device_scratch[NUM_SLOTS];
+    for (int slot = 0; slot < NUM_SLOTS; ++slot)
+    {
+        device_keys[slot] = clCreateBuffer(context, CL_MEM_READ_WRITE, run_length * sizeof(int), NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+        device_scratch[slot] = clCreateBuffer(context, CL_MEM_READ_WRITE, run_length * sizeof(int), NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    }
+
+    // events that order the three queues, one set per slot
+    cl_event uploaded[NUM_SLOTS] = {NULL, NULL};
+    cl_event sorted[NUM_SLOTS] = {NULL, NULL};
+    cl_event downloaded[NUM_SLOTS] = {NULL, NULL};
+
+    // 1. cut the input into runs, sort them on the device and spill them to mapped run files
+    const auto start_time = std::chrono::steady_clock::now();
+    std::vector<Run> runs(num_runs);
+    for (size_t run = 0; run < num_runs; ++run)
+    {
+        const int slot = run % NUM_SLOTS;
+        const size_t run_start = run * run_length;
+        const cl_int n = static_cast<cl_int>(std::min(run_length, length - run_start));
+        runs[run].length = n;
+        runs[run].file = createMappedFile(output_file_name + ".run" + std::to_string(run), n * sizeof(int));
+        runs[run].keys = static_cast<const int*>(runs[run].file.data);
+
+        // the slot can be refilled once the run that used it before has been downloaded
+        err = clEnqueueWriteBuffer(upload_queue, device_keys[slot], CL_FALSE, 0, n * sizeof(int), host_in + run_start,
+                                   downloaded[slot] ? 1 : 0, downloaded[slot] ? &downloaded[slot] : NULL, &uploaded[slot]);
+        CHECK_CL_ERROR(err, "Couldn't upload the run");
+        if (downloaded[slot])
+        {
+            clReleaseEvent(downloaded[slot]);
+            downloaded[slot] = NULL;
+        }
+
+        // the sort waits for the upload, the marker tells the download when the sort is over
+        err = clEnqueueWaitForEvents(compute_queue, 1, &uploaded[slot]);
+        CHECK_CL_ERROR(err, "Couldn't wait for the upload");
+        enqueueMergeSort(compute_queue, merge_sort, device_keys[slot], device_scratch[slot], n);
+        err = clEnqueueMarker(compute_queue, &sorted[slot]);
+        CHECK_CL_ERROR(err, "Couldn't enqueue the marker");
+        clReleaseEvent(uploaded[slot]);
+        uploaded[slot] = NULL;
+
+        // the sorted run goes straight into its mapped file
+        err = clEnqueueReadBuffer(download_queue, device_keys[slot], CL_FALSE, 0, n * sizeof(int), runs[run].file.data,
+                                  1, &sorted[slot], &downloaded[slot]);
+        CHECK_CL_ERROR(err, "Couldn't download the run");
+        clReleaseEvent(sorted[slot]);
+        sorted[slot] = NULL;
+
+        // make sure the work is submitted while the host enqueues the next run
+        clFlush(upload_queue);
+        clFlush(compute_queue);
+        clFlush(download_queue);
+    }
+
+    // wait until all the runs are compeletely read from device
+    err = clFinish(download_queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+    const auto runs_time = std::chrono::steady_clock::now();
+
+    // Release device resources
+    for (int slot = 0; slot < NUM_SLOTS; ++slot)
+    {
+        if (downloaded[slot])
+        {
+            clReleaseEvent(downloaded[slot]);
+        }
+        clReleaseMemObject(device_keys[slot]);
+        clReleaseMemObject(device_scratch[slot]);
+    }
+    releaseMergeSort(merge_sort);
+    clReleaseCommandQueue(upload_queue);
+    clReleaseCommandQueue(compute_queue);
+    clReleaseCommandQueue(download_queue);
+    clReleaseContext(context);
+    closeMappedFile(input);
+
+    // the runs are read back through read-only mappings
+    for (size_t run = 0; run < num_runs; ++run)
+    {
+        closeMappedFile(runs[run].file);
+        runs[run].file = openMappedFile(output_file_name + ".run" + std::to_string(run));
+        runs[run].keys = static_cast<const int*>(runs[run].file.data);
+    }
+
+    // 2. k-way merge of the runs on host threads, every thread merges the keys between two splitters
+    // the splitters are quantiles of evenly spaced samples of the runs
+    std::vector<int> samples;
+    for (const Run& run : runs)
+    {
+        for (size_t s = 0; s < SAMPLES_PER_RUN; ++s)
+        {
+            samples.push_back(run.keys[s * run.length / SAMPLES_PER_RUN]);
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+    std::vector<int> splitters(num_threads - 1);
+    for (unsigned t = 1; t < num_threads; ++t)
+    {
+        splitters[t - 1] = samples[t * samples.size() / num_threads];
+    }
+
+    MappedFile output = createMappedFile(output_file_name, length * sizeof(int));
+    int* host_out = static_cast<int*>(output.data);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t)
+    {
+        const int* lower = (t > 0) ? &splitters[t - 1] : nullptr;
+        const int* upper = (t + 1 < num_threads) ? &splitters[t] : nullptr;
+        // the part starts after all the keys below its lower splitter
+        size_t part_start = 0;
+        for (const Run& run : runs)
+        {
+            part_start += lower ? std::lower_bound(run.keys, run.keys + run.length, *lower) - run.keys : 0;
+        }
+        threads.emplace_back(mergeRunPart, std::cref(runs), lower, upper, host_out + part_start);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+
+    const double run_seconds = std::chrono::duration<double>(runs_time - start_time).count();
+    const double merge_seconds = std::chrono::duration<double>(end_time - runs_time).count();
+    std::cout << "Sorted " << length << " keys in " << num_runs << " runs of " << run_length << " keys: "
+              << run_seconds << " s to sort the runs, " << merge_seconds << " s to merge them on " << num_threads << " threads" << std::endl;
+    std::cout << length << " keys sorted: " << (std::is_sorted(host_out, host_out + length) ? "yes" : "no") << std::endl;
+
+    // the run files aren't needed anymore
+    for (size_t run = 0; run < num_runs; ++run)
+    {
+        closeMappedFile(runs[run].file);
+        std::remove((output_file_name + ".run" + std::to_string(run)).c_str());
+    }
+    // the output is already on disk, unmapping flushes it
+    closeMappedFile(output);
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#ifndef COMMON_H
+#define COMMON_H
+
+#include <algorithm>
+#include <cassert>
+#include <CL/cl.h>
+#include <cstring>
+#include <fstream>
+#include <streambuf>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define CHECK_CL_ERROR(err, msg) assert(err == CL_SUCCESS && msg)
+
+/*
+reads a file that contains the definiton of ONE kernel
+returns it as a string
+*/
+std::string readFile(const std::string& file_name) {
+    std::ifstream file("include/" + file_name);
+    assert(file.is_open() && "Couldn't open the file to read the kernel");
+    // Read the entire file into a string
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/*
+a file mapped into the address space of the process
+the OS pages it in and out on demand, so it can be larger than host memory
+*/
+struct MappedFile
+{
+    void* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int file = -1;
+#endif
+};
+
+/*
+maps an existing file read-only
+returns a MappedFile with data == nullptr if the file can't be opened
+*/
+MappedFile openMappedFile(const std::string& file_name)
+{
+    MappedFile mapped;
+#ifdef _WIN32
+    mapped.file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mapped.file == INVALID_HANDLE_VALUE)
+    {
+        return mapped;
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(mapped.file, &file_size);
+    mapped.size = static_cast<size_t>(file_size.QuadPart);
+    mapped.mapping = CreateFileMappingA(mapped.file, NULL, PAGE_READONLY, 0, 0, NULL);
+    assert(mapped.mapping != NULL && "Couldn't map the input file");
+    mapped.data = MapViewOfFile(mapped.mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    mapped.file = open(file_name.c_str(), O_RDONLY);
+    if (mapped.file < 0)
+    {
+        return mapped;
+    }
+    struct stat file_stat;
+    fstat(mapped.file, &file_stat);
+    mapped.size = static_cast<size_t>(file_stat.st_size);
+    mapped.data = mmap(NULL, mapped.size, PROT_READ, MAP_SHARED, mapped.file, 0);
+    assert(mapped.data != MAP_FAILED && "Couldn't map the input file");
+    // the file is consumed front to back, let the OS read ahead
+    madvise(mapped.data, mapped.size, MADV_SEQUENTIAL);
+#endif
+    return mapped;
+}
+
+/*
+creates (or truncates) a file of the given size and maps it read-write
+*/
+MappedFile createMappedFile(const std::string& file_name, const size_t size)
+{
+    MappedFile mapped;
+    mapped.size = size;
+#ifdef _WIN32
+    mapped.file = CreateFileA(file_name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    assert(mapped.file != INVALID_HANDLE_VALUE && "Couldn't create the output file");
+    const DWORD size_high = static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32);
+    const DWORD size_low = static_cast<DWORD>(size & 0xFFFFFFFFu);
+    mapped.mapping = CreateFileMappingA(mapped.file, NULL, PAGE_READWRITE, size_high, size_low, NULL);
+    assert(mapped.mapping != NULL && "Couldn't map the output file");
+    mapped.data = MapViewOfFile(mapped.mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+#else
+    mapped.file = open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    assert(mapped.file >= 0 && "Couldn't create the output file");
+    const int truncate_result = ftruncate(mapped.file, static_cast<off_t>(size));
+    assert(truncate_result == 0 && "Couldn't resize the output file");
+    (void)truncate_result;
+    mapped.data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, mapped.file, 0);
+    assert(mapped.data != MAP_FAILED && "Couldn't map the output file");
+#endif
+    return mapped;
+}
+
+/*
+unmaps the file and closes it, pending writes are flushed by the OS
+*/
+void closeMappedFile(MappedFile& mapped)
+{
+#ifdef _WIN32
+    if (mapped.data != nullptr)
+    {
+        UnmapViewOfFile(mapped.data);
+    }
+    if (mapped.mapping != NULL)
+    {
+        CloseHandle(mapped.mapping);
+    }
+    if (mapped.file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(mapped.file);
+    }
+    mapped.mapping = NULL;
+    mapped.file = INVALID_HANDLE_VALUE;
+#else
+    if (mapped.data != nullptr)
+    {
+        munmap(mapped.data, mapped.size);
+    }
+    if (mapped.file >= 0)
+    {
+        close(mapped.file);
+    }
+    mapped.file = -1;
+#endif
+    mapped.data = nullptr;
+    mapped.size = 0;
+}
+
+/*
+asks the OS to start reading [offset, offset + size) of a mapped file in the background, it doesn't wait for the read
+*/
+void prefetchMappedFile(const MappedFile& mapped, size_t offset, size_t size)
+{
+    if (offset >= mapped.size)
+    {
+        return;
+    }
+    size = std::min(size, mapped.size - offset);
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = static_cast<char*>(mapped.data) + offset;
+    range.NumberOfBytes = size;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise works on whole pages
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t page_offset = offset / page_size * page_size;
+    madvise(static_cast<char*>(mapped.data) + page_offset, size + (offset - page_offset), MADV_WILLNEED);
+#endif
+}
+
+#endif
\ No newline at end of file
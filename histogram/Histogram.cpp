@@ -0,0 +1,121 @@
+#include "include/Data.h"
+#include "include/common.h"
+#include "include/Histogram.h"
+#include <iostream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <vector>
+// OpenCL includes
+#include <CL/cl.h>
+
+int main()
+{
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue queue;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the queue");
+
+    const auto file_name = "kernels.clh";
+    const auto kernel_source_string = readFile(file_name);
+
+    // read data
+    std::vector<int> host_data = data;  // copy
+    const int length = static_cast<int>(host_data.size());
+    const size_t size_in_byte = length * sizeof(decltype(host_data.at(0)));
+    assert((length > 0) && "Invalid Length: length must be positive");
+
+    // the binning functions are OpenCL C expressions of x (the element), they are compiled into the kernels
+    // data is in [-1000, 1000]: 16 coarse bins, then one bin per value
+    const std::vector<std::string> bin_ofs = {"(x + 1000) * 16 / 2001", "x + 1000"};
+    const std::vector<int> nums_bins = {16, 2001};
+
+    // create buffer(s)
+    cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_ONLY, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    std::vector<cl_mem> device_bins;
+    for (const int num_bins : nums_bins)
+    {
+        device_bins.push_back(clCreateBuffer(context, CL_MEM_READ_WRITE, num_bins * sizeof(cl_uint), NULL, &err));
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    }
+
+    // transfer data to GPU
+    clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+    std::vector<Histogram> histograms;
+    for (size_t h = 0; h < bin_ofs.size(); ++h)
+    {
+        histograms.push_back(createHistogram<cl_int>(context, device, kernel_source_string, bin_ofs[h], nums_bins[h]));
+        std::cout << nums_bins[h] << " bins: " << (histograms.back().privatized ? "local bins per work-group" : "global atomics") << std::endl;
+        enqueueHistogram(queue, histograms.back(), device_data, length, device_bins[h]);
+    }
+
+    // wait until execution of the kernels is over
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // read the kernels' output
+    std::vector<std::vector<cl_uint>> host_bins;
+    for (size_t h = 0; h < bin_ofs.size(); ++h)
+    {
+        host_bins.emplace_back(nums_bins[h]);
+        clEnqueueReadBuffer(queue, device_bins[h], CL_TRUE, 0, nums_bins[h] * sizeof(cl_uint), host_bins.back().data(), 0, NULL, NULL);
+    }
+
+    // wait until data is compeletely read from device
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // Release resources
+    for (size_t h = 0; h < bin_ofs.size(); ++h)
+    {
+        clReleaseMemObject(device_bins[h]);
+        releaseHistogram(histograms[h]);
+    }
+    clReleaseMemObject(device_data);
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+
+    // write the result to disk, one histogram per line
+    const std::string output_file_name = "out.txt";
+    std::ofstream out(output_file_name);
+    if (out.is_open())
+    {
+        for (const auto& bins : host_bins)
+        {
+            std::copy(bins.cbegin(), bins.cend(), std::ostream_iterator<cl_uint>(out, " "));
+            out << "\n";
+        }
+        out.close();
+    }
+    else
+    {
+        std::cerr << "Couldn't open the output file" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "common.h"
+#include <algorithm>
+#include <string>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define HISTOGRAM_GROUP_SIZE 256
+#define HISTOGRAM_GROUPS_PER_COMPUTE_UNIT 4
+#define HISTOGRAM_MAX_LOCAL_COPIES 8
+
+/*
+OpenCL C spelling of a host type
+*/
+template <typename T>
+struct HistogramType;
+
+template <>
+struct HistogramType<cl_int>
+{
+    static constexpr const char* name = "int";
+};
+
+template <>
+struct HistogramType<cl_uint>
+{
+    static constexpr const char* name = "uint";
+};
+
+template <>
+struct HistogramType<cl_uchar>
+{
+    static constexpr const char* name = "uchar";
+};
+
+template <>
+struct HistogramType<cl_float>
+{
+    static constexpr const char* name = "float";
+};
+
+/*
+a histogram compiled for one element type, one number of bins and one binning function
+*/
+struct Histogram
+{
+    cl_program program = NULL;
+    cl_kernel kernel_clear = NULL;
+    cl_kernel kernel_count = NULL;
+    int num_bins = 0;
+    bool privatized = false;  // local bins merged at the end, or global atomics for every element
+    size_t local_size = 0;
+    size_t num_groups = 0;
+};
+
+/*
+builds the histogram kernels (kernel_source is the content of histogram/include/kernels.clh)
+bin_of is an OpenCL C expression of x (the element) that returns its bin as an int
+*/
+template <typename T>
+Histogram createHistogram(cl_context context, cl_device_id device, const std::string& kernel_source,
+                          const std::string& bin_of, const int num_bins)
+{
+    assert(num_bins > 0 && "A histogram needs at least one bin");
+    cl_int err = CL_SUCCESS;
+    Histogram histogram;
+    histogram.num_bins = num_bins;
+
+    // as many copies of the bins as local memory allows (half of it, to leave room to the compiler)
+    cl_ulong local_mem_size;
+    clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(local_mem_size), &local_mem_size, NULL);
+    const size_t max_local_counters = static_cast<size_t>(local_mem_size / 2 / sizeof(cl_uint));
+    const size_t local_copies = std::min<size_t>(HISTOGRAM_MAX_LOCAL_COPIES, max_local_counters / num_bins);
+    histogram.privatized = (local_copies > 0);
+
+    std::string options = std::string("-D VALUE_T=") + HistogramType<T>::name + " -D NUM_BINS=" + std::to_string(num_bins);
+    if (histogram.privatized)
+    {
+        options += " -D LOCAL_COPIES=" + std::to_string(local_copies);
+    }
+
+    // the binning function is compiled into the kernels
+    const std::string bin_of_source_string = "#define BIN_OF(x) ((int)(" + bin_of + "))\n";
+    const char* sources[] = {bin_of_source_string.c_str(), kernel_source.c_str()};
+    histogram.program = clCreateProgramWithSource(context, 2, sources, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the histogram program");
+    err = clBuildProgram(histogram.program, 1, &device, options.c_str(), NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't build the histogram program, check the binning function");
+
+    histogram.kernel_clear = clCreateKernel(histogram.program, "clearHistogram", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the clearHistogram kernel");
+    histogram.kernel_count = clCreateKernel(histogram.program, histogram.privatized ? "histogramLocal" : "histogramGlobal", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the histogram kernel");
+
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    histogram.local_size = std::min<size_t>(HISTOGRAM_GROUP_SIZE, max_work_group_size);
+
+    // enough work-groups to fill the device, every extra work-group is one more merge into global memory
+    cl_uint compute_units;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(compute_units), &compute_units, NULL);
+    histogram.num_groups = std::max<size_t>(1u, compute_units * HISTOGRAM_GROUPS_PER_COMPUTE_UNIT);
+
+    return histogram;
+}
+
+/*
+enqueues the histogram of the n elements of data into bins (num_bins uints), nothing is read back
+bins is overwritten, not accumulated into
+*/
+void enqueueHistogram(cl_command_queue queue, const Histogram& histogram, cl_mem data, const cl_int n, cl_mem bins)
+{
+    cl_int err = clSetKernelArg(histogram.kernel_clear, 0, sizeof(cl_mem), &bins);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+
+    err = clSetKernelArg(histogram.kernel_count, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(histogram.kernel_count, 1, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(histogram.kernel_count, 2, sizeof(cl_mem), &bins);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+    const size_t local_size = histogram.local_size;
+    // no more work-groups than the input needs
+    const size_t groups_needed = (static_cast<size_t>(n) + local_size - 1) / local_size;
+    const size_t global_size = std::max<size_t>(1u, std::min(groups_needed, histogram.num_groups)) * local_size;
+
+    err = clEnqueueNDRangeKernel(queue, histogram.kernel_clear, 1, NULL, &local_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the clearHistogram kernel");
+    // the in-order queue runs the count after the clear
+    err = clEnqueueNDRangeKernel(queue, histogram.kernel_count, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the histogram kernel");
+}
+
+void releaseHistogram(Histogram& histogram)
+{
+    clReleaseKernel(histogram.kernel_clear);
+    clReleaseKernel(histogram.kernel_count);
+    clReleaseProgram(histogram.program);
+    histogram = Histogram();
+}
+
+#endif
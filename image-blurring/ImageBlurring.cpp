@@ -120,6 +120,73 @@ int main()
     std::cout << "Max local memory size in bytes is: " << max_local_mem_size << std::endl;
 
 
+    // summed-area table of the original image, enqueued before the blur which overwrites device_data in place
+    // the queue is in-order, so the blur only starts once the table is complete
+    const size_t sat_size_in_byte = width * height * sizeof(cl_uint4);
+    cl_mem device_sat = clCreateBuffer(context, CL_MEM_READ_WRITE, sat_size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_box_filtered = clCreateBuffer(context, CL_MEM_WRITE_ONLY, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    cl_kernel kernel_sat_rows = clCreateKernel(program, "integralImageRows_uchar4", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the integralImageRows_uchar4 kernel");
+    cl_kernel kernel_sat_columns = clCreateKernel(program, "integralImageColumns_uchar4", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the integralImageColumns_uchar4 kernel");
+    cl_kernel kernel_box_filter = clCreateKernel(program, "boxFilter_uchar4", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the boxFilter_uchar4 kernel");
+
+    // any radius costs the same, the box filter does four lookups per pixel
+    const int box_radius = 7;
+
+    err = clSetKernelArg(kernel_sat_rows, 0, sizeof(cl_mem), &device_data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_sat_rows, 1, sizeof(cl_mem), &device_sat);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_sat_rows, 2, sizeof(width), &width);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(kernel_sat_rows, 3, sizeof(height), &height);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+
+    err = clSetKernelArg(kernel_sat_columns, 0, sizeof(cl_mem), &device_sat);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_sat_columns, 1, sizeof(width), &width);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_sat_columns, 2, sizeof(height), &height);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+    err = clSetKernelArg(kernel_box_filter, 0, sizeof(cl_mem), &device_sat);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_box_filter, 1, sizeof(cl_mem), &device_box_filtered);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_box_filter, 2, sizeof(width), &width);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(kernel_box_filter, 3, sizeof(height), &height);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clSetKernelArg(kernel_box_filter, 4, sizeof(box_radius), &box_radius);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+
+    // row pass: one work-group per row
+    const size_t sat_rows_local_size = std::min<size_t>(256u, max_work_group_size);
+    const size_t sat_rows_global_size = height * sat_rows_local_size;
+    err = clEnqueueNDRangeKernel(queue, kernel_sat_rows, 1, NULL, &sat_rows_global_size, &sat_rows_local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the integralImageRows_uchar4 kernel");
+
+    // column pass: one work-item per column
+    const size_t sat_columns_local_size = std::min<size_t>(64u, max_work_group_size);
+    const size_t sat_columns_global_size = (width + sat_columns_local_size - 1) / sat_columns_local_size * sat_columns_local_size;
+    err = clEnqueueNDRangeKernel(queue, kernel_sat_columns, 1, NULL, &sat_columns_global_size, &sat_columns_local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the integralImageColumns_uchar4 kernel");
+
+    // box filter: one work-item per pixel
+    const size_t box_local_size[] = {16u, 16u};
+    const size_t box_global_size[] = {(width + box_local_size[0] - 1) / box_local_size[0] * box_local_size[0],
+                                      (height + box_local_size[1] - 1) / box_local_size[1] * box_local_size[1]};
+    err = clEnqueueNDRangeKernel(queue, kernel_box_filter, 2, NULL, &box_global_size[0], &box_local_size[0], 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the boxFilter_uchar4 kernel");
+
     // set global and local sizes (grid and block sizes)
     // MAX number of threads is 512, so setting each dimention to 16 since 16x16 < 512
     size_t global_size[] = {16u, 16u};
@@ -136,19 +203,29 @@ int main()
     // read the kernel's output
     clEnqueueReadBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
 
+    std::vector<uint8_t> host_box_filtered(length);
+    clEnqueueReadBuffer(queue, device_box_filtered, CL_TRUE, 0, size_in_byte, host_box_filtered.data(), 0, NULL, NULL);
+
     // wait until data is compeletely read from device 
     err = clFinish(queue);
     CHECK_CL_ERROR(err, "Couldn't empty the queue");
 
     // Release resources
     clReleaseMemObject(device_data);
+    clReleaseMemObject(device_sat);
+    clReleaseMemObject(device_box_filtered);
     clReleaseKernel(kernel_image_blurring);
+    clReleaseKernel(kernel_sat_rows);
+    clReleaseKernel(kernel_sat_columns);
+    clReleaseKernel(kernel_box_filter);
     clReleaseProgram(program);
     clReleaseContext(context);
     
     // write the result to disk
     const std::string output_file_name = "out.png";
     stbi_write_png(output_file_name.c_str(), width, height, NUM_CHANNEL, host_data.data(), width * NUM_CHANNEL);
+    const std::string box_output_file_name = "out-box.png";
+    stbi_write_png(box_output_file_name.c_str(), width, height, NUM_CHANNEL, host_box_filtered.data(), width * NUM_CHANNEL);
 
     return 0;
 }
\ No newline at end of file
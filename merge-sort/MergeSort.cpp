@@ -0,0 +1,177 @@
+#include "include/Data.h"
+#include "include/common.h"
+#include "include/MergeSort.h"
+#include "../bitonic-sort/include/BitonicSort.h"
+#include <iostream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+// OpenCL includes
+#include <CL/cl.h>
+
+/*
+seconds taken by the fastest of a few runs of enqueue_sort on keys, the keys are uploaded again before every run
+*/
+template <typename EnqueueSort>
+double timeSort(cl_command_queue queue, cl_mem device_keys, const std::vector<int>& keys, EnqueueSort enqueue_sort)
+{
+    const int num_runs = 3;
+    double best_seconds = 0.0;
+    // one more run than measured, the first one warms up the kernels
+    for (int run = 0; run <= num_runs; ++run)
+    {
+        clEnqueueWriteBuffer(queue, device_keys, CL_TRUE, 0, keys.size() * sizeof(int), keys.data(), 0, NULL, NULL);
+        const auto start_time = std::chrono::steady_clock::now();
+        enqueue_sort();
+        clFinish(queue);
+        const auto end_time = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+        if (run == 1 || (run > 1 && seconds < best_seconds))
+        {
+            best_seconds = seconds;
+        }
+    }
+    return best_seconds;
+}
+
+/*
+sorts the keys of Data.h, or argv[1] random keys (any length)
+with --benchmark, times merge sort and bitonic sort on random keys from 2^10 up to argv[2] keys (2^24 by default)
+*/
+int main(int argc, char** argv)
+{
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue queue;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the queue");
+
+    // create the merge sort program from kernel source code
+    const auto file_name = "kernels.clh";
+    const auto kernel_source_string = readFile(file_name);
+    MergeSort merge_sort = createMergeSort(context, device, kernel_source_string);
+
+    std::mt19937 generator(42);
+    const bool benchmark = (argc > 1 && std::string(argv[1]) == "--benchmark");
+    if (benchmark)
+    {
+        // the bitonic sort of the bitonic-sort project, on the same keys
+        const auto bitonic_kernel_source_string = readFile("../../bitonic-sort/include/kernels.clh");
+        BitonicSort bitonic_sort = createBitonicSort(context, device, bitonic_kernel_source_string);
+
+        const size_t max_length = (argc > 2) ? std::stoul(argv[2]) : (size_t(1) << 24);
+        for (size_t length = 1024; length <= max_length; length *= 4)
+        {
+            std::vector<int> keys(length);
+            std::generate(keys.begin(), keys.end(), generator);
+            const size_t size_in_byte = length * sizeof(int);
+            cl_mem device_keys = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+            CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+            cl_mem device_scratch = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+            CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+            const cl_int n = static_cast<cl_int>(length);
+            const double merge_seconds = timeSort(queue, device_keys, keys, [&]() {
+                enqueueMergeSort(queue, merge_sort, device_keys, device_scratch, n);
+            });
+            const double bitonic_seconds = timeSort(queue, device_keys, keys, [&]() {
+                enqueueBitonicSort(queue, bitonic_sort, device_keys, n);
+            });
+            std::cout << length << " keys: merge sort " << length / merge_seconds / 1e6 << " Mkeys/s, bitonic sort "
+                      << length / bitonic_seconds / 1e6 << " Mkeys/s" << std::endl;
+
+            clReleaseMemObject(device_keys);
+            clReleaseMemObject(device_scratch);
+        }
+
+        releaseBitonicSort(bitonic_sort);
+        releaseMergeSort(merge_sort);
+        clReleaseCommandQueue(queue);
+        clReleaseContext(context);
+        return 0;
+    }
+
+    // read data
+    std::vector<int> host_data = data;  // copy
+    if (argc > 1)
+    {
+        host_data.resize(std::stoul(argv[1]));
+        std::generate(host_data.begin(), host_data.end(), generator);
+    }
+    const size_t length = host_data.size();
+    const size_t size_in_byte = length * sizeof(decltype(host_data.at(0)));
+    assert((length > 0) && "Invalid Length: length must be positive");
+
+    // create buffer(s)
+    cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_scratch = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    // transfer data to GPU
+    clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+    // enqueue the tile sort and all the merge passes
+    enqueueMergeSort(queue, merge_sort, device_data, device_scratch, static_cast<cl_int>(length));
+
+    // wait until execution of the kernels is over
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // read the kernel's output
+    clEnqueueReadBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+    // wait until data is compeletely read from device
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // Release resources
+    clReleaseMemObject(device_data);
+    clReleaseMemObject(device_scratch);
+    releaseMergeSort(merge_sort);
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+
+    std::cout << length << " keys sorted: " << (std::is_sorted(host_data.cbegin(), host_data.cend()) ? "yes" : "no") << std::endl;
+
+    // write the result to disk
+    const std::string output_file_name = "out.txt";
+    std::ofstream out(output_file_name);
+    if (out.is_open())
+    {
+        // copy the content of host_data to disk
+        std::copy(host_data.cbegin(), host_data.cend(), std::ostream_iterator<int>(out, " "));
+        out.close();
+    }
+    else
+    {
+        std::cerr << "Couldn't open the output file" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+#ifndef MERGE_SORT_H
+#define MERGE_SORT_H
+
+#include "common.h"
+#include <algorithm>
+#include <string>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define MERGE_SORT_TILE_LENGTH 1024  // must match the value in kernels.clh
+#define MERGE_SORT_GROUP_SIZE 256
+
+/*
+OpenCL C spelling of a key type and of its order, compiled into the kernels
+definitions is prepended to the kernels (e.g. the typedef of a struct key), less(a, b) is an expression of a and b
+a struct key needs a host struct with the same layout and its own specialization, for example
+    struct Point { cl_int x; cl_int y; };
+    template <> struct MergeSortKeyType<Point>
+    {
+        static constexpr const char* name = "Point";
+        static constexpr const char* definitions = "typedef struct { int x; int y; } Point;";
+        static constexpr const char* less = "((a).x < (b).x || ((a).x == (b).x && (a).y < (b).y))";
+    };
+*/
+template <typename K>
+struct MergeSortKeyType;
+
+template <>
+struct MergeSortKeyType<cl_int>
+{
+    static constexpr const char* name = "int";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "((a) < (b))";
+};
+
+template <>
+struct MergeSortKeyType<cl_uint>
+{
+    static constexpr const char* name = "uint";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "((a) < (b))";
+};
+
+template <>
+struct MergeSortKeyType<cl_long>
+{
+    static constexpr const char* name = "long";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "((a) < (b))";
+};
+
+template <>
+struct MergeSortKeyType<cl_ulong>
+{
+    static constexpr const char* name = "ulong";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "((a) < (b))";
+};
+
+// NaNs go after every number (before them when descending), and all NaNs are equivalent
+template <>
+struct MergeSortKeyType<cl_float>
+{
+    static constexpr const char* name = "float";
+    static constexpr const char* definitions = "";
+    static constexpr const char* less = "(isnan(b) ? !isnan(a) : ((a) < (b)))";
+};
+
+template <>
+struct MergeSortKeyType<cl_double>
+{
+    static constexpr const char* name = "double";
+    static constexpr const char* definitions = "#pragma OPENCL EXTENSION cl_khr_fp64 : enable";
+    static constexpr const char* less = "(isnan(b) ? !isnan(a) : ((a) < (b)))";
+};
+
+/*
+the two merge sort kernels of one program
+*/
+struct MergeSort
+{
+    cl_program program = NULL;
+    cl_kernel kernel_sort_tiles = NULL;
+    cl_kernel kernel_merge_pass = NULL;
+    size_t local_size = 0;
+};
+
+/*
+builds the merge sort kernels (kernel_source is the content of merge-sort/include/kernels.clh)
+for keys of type K, in ascending or descending order
+*/
+template <typename K = cl_int>
+MergeSort createMergeSort(cl_context context, cl_device_id device, const std::string& kernel_source, const bool descending = false)
+{
+    const std::string options = std::string("-D KEY_T=") + MergeSortKeyType<K>::name + (descending ? " -D SORT_DESCENDING" : "");
+    // the comparator is an expression, it's prepended to the kernels rather than passed as a build option
+    const std::string key_source_string = std::string(MergeSortKeyType<K>::definitions) + "\n" +
+                                          "#define KEY_LESS(a, b) (" + MergeSortKeyType<K>::less + ")\n";
+
+    cl_int err = CL_SUCCESS;
+    MergeSort sort;
+    const char* sources[] = {key_source_string.c_str(), kernel_source.c_str()};
+    sort.program = clCreateProgramWithSource(context, 2, sources, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the merge sort program");
+    err = clBuildProgram(sort.program, 1, &device, options.c_str(), NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't build the merge sort program");
+
+    sort.kernel_sort_tiles = clCreateKernel(sort.program, "mergeSortTiles", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the mergeSortTiles kernel");
+    sort.kernel_merge_pass = clCreateKernel(sort.program, "mergeSortPass", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the mergeSortPass kernel");
+
+    // every work-item handles the same number of keys of a tile, so the work-group size is a power of two
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    sort.local_size = MERGE_SORT_GROUP_SIZE;
+    while (sort.local_size > max_work_group_size)
+    {
+        sort.local_size /= 2;
+    }
+
+    return sort;
+}
+
+/*
+enqueues the stable sort of the n keys of data in the order the sort was built for, nothing is read back
+scratch is a buffer of the same size as data, the passes go back and forth between the two and the result ends in data
+*/
+void enqueueMergeSort(cl_command_queue queue, const MergeSort& sort, cl_mem data, cl_mem scratch, const cl_int n)
+{
+    assert((n > 0) && "Invalid Length: length must be positive");
+    cl_int err = CL_SUCCESS;
+
+    int num_passes = 0;
+    for (cl_int width = MERGE_SORT_TILE_LENGTH; width < n; width *= 2)
+    {
+        ++num_passes;
+    }
+
+    const size_t local_size = sort.local_size;
+    const size_t num_tiles = (n + MERGE_SORT_TILE_LENGTH - 1) / MERGE_SORT_TILE_LENGTH;
+    const size_t global_size = num_tiles * local_size;
+
+    // the tiles are sorted into the buffer that makes the last pass write to data
+    cl_mem input = data;
+    cl_mem output = (num_passes % 2 == 0) ? data : scratch;
+
+    // 1. sort every tile
+    err = clSetKernelArg(sort.kernel_sort_tiles, 0, sizeof(cl_mem), &input);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_sort_tiles, 1, sizeof(cl_mem), &output);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_sort_tiles, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clEnqueueNDRangeKernel(queue, sort.kernel_sort_tiles, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the mergeSortTiles kernel");
+
+    // 2. merge runs of 1024, 2048, ... keys, the in-order queue keeps the passes in order
+    err = clSetKernelArg(sort.kernel_merge_pass, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    for (cl_int width = MERGE_SORT_TILE_LENGTH; width < n; width *= 2)
+    {
+        input = output;
+        output = (input == data) ? scratch : data;
+        err = clSetKernelArg(sort.kernel_merge_pass, 0, sizeof(cl_mem), &input);
+        CHECK_CL_ERROR(err, "Couldn't set arg 1");
+        err = clSetKernelArg(sort.kernel_merge_pass, 1, sizeof(cl_mem), &output);
+        CHECK_CL_ERROR(err, "Couldn't set arg 2");
+        err = clSetKernelArg(sort.kernel_merge_pass, 3, sizeof(width), &width);
+        CHECK_CL_ERROR(err, "Couldn't set arg 4");
+        err = clEnqueueNDRangeKernel(queue, sort.kernel_merge_pass, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the mergeSortPass kernel");
+    }
+}
+
+void releaseMergeSort(MergeSort& sort)
+{
+    clReleaseKernel(sort.kernel_sort_tiles);
+    clReleaseKernel(sort.kernel_merge_pass);
+    clReleaseProgram(sort.program);
+    sort = MergeSort();
+}
+
+#endif
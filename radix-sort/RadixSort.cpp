@@ -1,13 +1,317 @@
 #include "include/Data.h"
 #include "include/common.h"
+#include "include/RadixSort.h"
 #include <iostream>
 #include <string>
 #include <iterator>
 #include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 // OpenCL includes
 #include <CL/cl.h>
 
-int main()
+/*
+length random keys of type K, the float keys get NaNs, infinities and both zeros mixed in
+*/
+template <typename K>
+std::vector<K> randomKeys(const size_t length)
+{
+    std::mt19937_64 generator(42);
+    std::vector<K> keys(length);
+    if (std::is_floating_point<K>::value)
+    {
+        std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+        const K special_keys[] = {std::numeric_limits<K>::quiet_NaN(), std::numeric_limits<K>::infinity(),
+                                  -std::numeric_limits<K>::infinity(), K(0.0), K(-0.0)};
+        for (size_t i = 0; i < length; ++i)
+        {
+            keys[i] = (generator() % 16 == 0) ? special_keys[generator() % 5] : static_cast<K>(distribution(generator));
+        }
+    }
+    else
+    {
+        std::generate(keys.begin(), keys.end(), [&]() { return static_cast<K>(generator()); });
+    }
+    return keys;
+}
+
+/*
+length random nanosecond timestamps of one day, 64-bit keys that only differ in their low 47 bits
+*/
+std::vector<cl_long> randomTimestamps(const size_t length)
+{
+    std::mt19937_64 generator(42);
+    const cl_long day_start = 1700000000ll * 1000000000ll;
+    const cl_long day_length = 86400ll * 1000000000ll;
+    std::vector<cl_long> timestamps(length);
+    std::generate(timestamps.begin(), timestamps.end(), [&]() { return day_start + static_cast<cl_long>(generator() % day_length); });
+    return timestamps;
+}
+
+/*
+sorts the keys of type K with the device-wide radix sort, with a payload of the given kind, prints the throughput
+and returns whether the result matches std::stable_sort (NaNs last, the zeros in their original order)
+*/
+template <typename K>
+bool sortKeys(cl_context context, cl_device_id device, cl_command_queue queue, const std::string& kernel_source_string,
+              std::vector<K> host_keys, const RadixPayload payload)
+{
+    cl_int err = CL_SUCCESS;
+    const size_t length = host_keys.size();
+    const size_t size_in_byte = length * sizeof(K);
+
+    RadixSort radix_sort = createRadixSort<K>(context, device, kernel_source_string, payload);
+    cl_mem device_keys = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_scratch = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    clEnqueueWriteBuffer(queue, device_keys, CL_TRUE, 0, size_in_byte, host_keys.data(), 0, NULL, NULL);
+
+    // the payload of the i-th key is derived from i (i itself for an argsort), the low bytes are kept for 32-bit payloads
+    const auto payload_of = [payload](const size_t i) -> cl_ulong {
+        return (payload == RadixPayload::ArgSort) ? i : (i * 0x9E3779B97F4A7C15ull) ^ i;
+    };
+    const size_t payload_size = radix_sort.payload_size;
+    std::vector<unsigned char> host_payload(length * payload_size);
+    cl_mem device_payload = NULL;
+    cl_mem device_payload_scratch = NULL;
+    if (payload != RadixPayload::None)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            const cl_ulong value = payload_of(i);
+            std::memcpy(&host_payload[i * payload_size], &value, payload_size);
+        }
+        device_payload = clCreateBuffer(context, CL_MEM_READ_WRITE, length * payload_size, NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+        device_payload_scratch = clCreateBuffer(context, CL_MEM_READ_WRITE, length * payload_size, NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+        clEnqueueWriteBuffer(queue, device_payload, CL_TRUE, 0, length * payload_size, host_payload.data(), 0, NULL, NULL);
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const int num_passes = enqueueRadixSort(queue, radix_sort, device_keys, device_scratch, static_cast<cl_int>(length), -1,
+                     device_payload, device_payload_scratch);
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+    const auto end_time = std::chrono::steady_clock::now();
+
+    std::vector<K> sorted_keys(length);
+    clEnqueueReadBuffer(queue, device_keys, CL_TRUE, 0, size_in_byte, sorted_keys.data(), 0, NULL, NULL);
+    std::vector<unsigned char> sorted_payload(length * payload_size);
+    if (payload != RadixPayload::None)
+    {
+        clEnqueueReadBuffer(queue, device_payload, CL_TRUE, 0, length * payload_size, sorted_payload.data(), 0, NULL, NULL);
+    }
+
+    // stable argsort on the host, it gives both the expected keys and the expected payloads
+    std::vector<size_t> permutation(length);
+    for (size_t i = 0; i < length; ++i)
+    {
+        permutation[i] = i;
+    }
+    std::stable_sort(permutation.begin(), permutation.end(), [&host_keys](const size_t i, const size_t j) {
+        const K a = host_keys[i];
+        const K b = host_keys[j];
+        return std::isnan(static_cast<double>(b)) ? !std::isnan(static_cast<double>(a)) : a < b;
+    });
+    std::vector<K> expected_keys(length);
+    std::vector<unsigned char> expected_payload(length * payload_size);
+    for (size_t i = 0; i < length; ++i)
+    {
+        expected_keys[i] = host_keys[permutation[i]];
+        const cl_ulong value = payload_of(permutation[i]);
+        std::memcpy(&expected_payload[i * payload_size], &value, payload_size);
+    }
+
+    // every pass reads the keys twice (count and scatter) and writes them once
+    const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+    const double bytes_moved = 3.0 * num_passes * size_in_byte;
+    std::cout << "Sorted " << length << " keys in " << num_passes << " passes: " << seconds << " s, " << length / seconds / 1e6 << " Mkeys/s, "
+              << bytes_moved / seconds / 1e9 << " GB/s" << std::endl;
+
+    if (payload != RadixPayload::None)
+    {
+        clReleaseMemObject(device_payload);
+        clReleaseMemObject(device_payload_scratch);
+    }
+    clReleaseMemObject(device_keys);
+    clReleaseMemObject(device_scratch);
+    releaseRadixSort(radix_sort);
+
+    // compares the bits, so NaNs compare equal and -0.0 differs from 0.0
+    return std::memcmp(sorted_keys.data(), expected_keys.data(), size_in_byte) == 0 && sorted_payload == expected_payload;
+}
+
+/*
+sorts length random keys of type K cut into random segments of 0 to max_segment_length keys with the segmented radix sort,
+with a payload of the given kind, prints the throughput and returns whether every segment matches std::stable_sort
+*/
+template <typename K>
+bool sortSegments(cl_context context, cl_device_id device, cl_command_queue queue, const std::string& kernel_source_string,
+                  const size_t length, const int max_segment_length, const RadixPayload payload)
+{
+    cl_int err = CL_SUCCESS;
+    const std::vector<K> host_keys = randomKeys<K>(length);
+    const size_t size_in_byte = length * sizeof(K);
+
+    // the segments can be empty, but a positive maximum length moves the offset forward
+    assert((max_segment_length > 0) && "Invalid Segment Length: the maximum length of the segments must be positive");
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> segment_lengths(0, max_segment_length);
+    std::vector<cl_int> segment_offsets;
+    for (size_t offset = 0; offset < length; offset += segment_lengths(generator))
+    {
+        segment_offsets.push_back(static_cast<cl_int>(offset));
+    }
+    const cl_int num_segments = static_cast<cl_int>(segment_offsets.size());
+
+    SegmentedRadixSort segmented_sort = createSegmentedRadixSort<K>(context, device, kernel_source_string, payload);
+    cl_mem device_keys = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_offsets = clCreateBuffer(context, CL_MEM_READ_ONLY, num_segments * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    clEnqueueWriteBuffer(queue, device_keys, CL_TRUE, 0, size_in_byte, host_keys.data(), 0, NULL, NULL);
+    clEnqueueWriteBuffer(queue, device_offsets, CL_TRUE, 0, num_segments * sizeof(cl_int), segment_offsets.data(), 0, NULL, NULL);
+
+    // the payload of the i-th key is i, so the expected payload is the permutation of the stable sort (for all the kinds)
+    const size_t payload_size = segmented_sort.payload_size;
+    std::vector<unsigned char> host_payload(length * payload_size);
+    cl_mem device_payload = NULL;
+    if (payload != RadixPayload::None)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            const cl_ulong value = i;
+            std::memcpy(&host_payload[i * payload_size], &value, payload_size);
+        }
+        device_payload = clCreateBuffer(context, CL_MEM_READ_WRITE, length * payload_size, NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+        clEnqueueWriteBuffer(queue, device_payload, CL_TRUE, 0, length * payload_size, host_payload.data(), 0, NULL, NULL);
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const int num_passes = enqueueSegmentedRadixSort(queue, segmented_sort, device_keys, static_cast<cl_int>(length),
+                                                     device_offsets, num_segments, device_payload);
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+    const auto end_time = std::chrono::steady_clock::now();
+
+    std::vector<K> sorted_keys(length);
+    clEnqueueReadBuffer(queue, device_keys, CL_TRUE, 0, size_in_byte, sorted_keys.data(), 0, NULL, NULL);
+    std::vector<unsigned char> sorted_payload(length * payload_size);
+    if (payload != RadixPayload::None)
+    {
+        clEnqueueReadBuffer(queue, device_payload, CL_TRUE, 0, length * payload_size, sorted_payload.data(), 0, NULL, NULL);
+    }
+
+    // stable argsort of every segment on the host
+    std::vector<size_t> permutation(length);
+    for (size_t i = 0; i < length; ++i)
+    {
+        permutation[i] = i;
+    }
+    for (cl_int segment = 0; segment < num_segments; ++segment)
+    {
+        const size_t segment_end = (segment + 1 < num_segments) ? segment_offsets[segment + 1] : length;
+        std::stable_sort(permutation.begin() + segment_offsets[segment], permutation.begin() + segment_end,
+                         [&host_keys](const size_t i, const size_t j) {
+                             const K a = host_keys[i];
+                             const K b = host_keys[j];
+                             return std::isnan(static_cast<double>(b)) ? !std::isnan(static_cast<double>(a)) : a < b;
+                         });
+    }
+    std::vector<K> expected_keys(length);
+    std::vector<unsigned char> expected_payload(length * payload_size);
+    for (size_t i = 0; i < length; ++i)
+    {
+        expected_keys[i] = host_keys[permutation[i]];
+        const cl_ulong value = permutation[i];
+        std::memcpy(&expected_payload[i * payload_size], &value, payload_size);
+    }
+
+    const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+    std::cout << "Sorted " << num_segments << " segments of " << length << " keys in " << num_passes << " passes: " << seconds
+              << " s, " << length / seconds / 1e6 << " Mkeys/s" << std::endl;
+
+    if (payload != RadixPayload::None)
+    {
+        clReleaseMemObject(device_payload);
+    }
+    clReleaseMemObject(device_keys);
+    clReleaseMemObject(device_offsets);
+    releaseSegmentedRadixSort(segmented_sort);
+
+    return std::memcmp(sorted_keys.data(), expected_keys.data(), size_in_byte) == 0 && sorted_payload == expected_payload;
+}
+
+/*
+seconds taken by the fastest of a few runs of the single work-group radixSort kernel built with options on keys,
+the keys are uploaded again before every run, sorted tells whether the last run sorted them
+*/
+double timeLocalRadixSort(cl_context context, cl_device_id device, cl_command_queue queue, const std::string& kernel_source_string,
+                          const char* options, const std::vector<int>& keys, bool& sorted)
+{
+    cl_int err = CL_SUCCESS;
+    const char* kernel_source = kernel_source_string.c_str();
+    cl_program program = clCreateProgramWithSource(context, 1, &kernel_source, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the program");
+    err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't build the program");
+    cl_kernel kernel_radix_sort = clCreateKernel(program, "radixSort", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radixSort kernel");
+
+    const size_t size_in_byte = keys.size() * sizeof(int);
+    cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    const cl_int n = static_cast<cl_int>(keys.size());
+    clSetKernelArg(kernel_radix_sort, 0, sizeof(cl_mem), &device_data);
+    clSetKernelArg(kernel_radix_sort, 1, sizeof(n), &n);
+    size_t global_size = 32u;
+    size_t local_size = 32u;
+
+    const int num_runs = 10;
+    double best_seconds = 0.0;
+    // one more run than measured, the first one warms up the kernel
+    for (int run = 0; run <= num_runs; ++run)
+    {
+        clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, keys.data(), 0, NULL, NULL);
+        const auto start_time = std::chrono::steady_clock::now();
+        err = clEnqueueNDRangeKernel(queue, kernel_radix_sort, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the radixSort kernel");
+        clFinish(queue);
+        const auto end_time = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+        if (run == 1 || (run > 1 && seconds < best_seconds))
+        {
+            best_seconds = seconds;
+        }
+    }
+
+    std::vector<int> sorted_keys(keys.size());
+    clEnqueueReadBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, sorted_keys.data(), 0, NULL, NULL);
+    sorted = std::is_sorted(sorted_keys.cbegin(), sorted_keys.cend());
+
+    clReleaseMemObject(device_data);
+    clReleaseKernel(kernel_radix_sort);
+    clReleaseProgram(program);
+    return best_seconds;
+}
+
+/*
+sorts the keys of Data.h in a single work-group
+or argv[1] random keys (any length, e.g. 100000000) of type argv[2] (uint by default, int, long, ulong, timestamps, float or double)
+with the device-wide radix sort, argv[3] adds a payload: payload32, payload64 or argsort
+with --benchmark, times radixSort on the keys of Data.h with the fused scan and with the former separate bucket scans
+with --segments, sorts argv[2] random keys of type argv[4] (uint by default, int or float) with payload argv[5]
+cut into random segments of 0 to argv[3] keys (positive, 8 by default) with the segmented radix sort
+*/
+int main(int argc, char** argv)
 {
     // initialize OpenCL
     cl_int err = CL_SUCCESS;
@@ -41,6 +345,99 @@ int main()
     // create a program from kernel source code
     const auto file_name = "kernels.clh";
     const auto kernel_source_string = readFile(file_name);
+
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+    {
+        bool fused_sorted = false;
+        bool separate_sorted = false;
+        const double fused_seconds = timeLocalRadixSort(context, device, queue, kernel_source_string, NULL, data, fused_sorted);
+        const double separate_seconds = timeLocalRadixSort(context, device, queue, kernel_source_string, "-D SEPARATE_BUCKET_SCANS",
+                                                           data, separate_sorted);
+        std::cout << data.size() << " keys: fused scan " << fused_seconds * 1e6 << " us (sorted: " << (fused_sorted ? "yes" : "no")
+                  << "), separate bucket scans " << separate_seconds * 1e6 << " us (sorted: " << (separate_sorted ? "yes" : "no")
+                  << "), speedup " << separate_seconds / fused_seconds << std::endl;
+
+        clReleaseCommandQueue(queue);
+        clReleaseContext(context);
+        return 0;
+    }
+
+    const bool segments = (argc > 1 && std::string(argv[1]) == "--segments");
+    if (argc > 1)
+    {
+        // --segments takes the maximum length of the segments after the number of keys
+        const int first_arg = segments ? 2 : 1;
+        const size_t length = std::stoul(argv[first_arg]);
+        assert((length > 0) && "Invalid Length: length must be positive");
+        const int max_segment_length = segments ? ((argc > 3) ? std::stoi(argv[3]) : 8) : 0;
+        const int type_arg = segments ? first_arg + 2 : first_arg + 1;
+        const std::string key_type = (argc > type_arg) ? argv[type_arg] : "uint";
+        const std::string payload_name = (argc > type_arg + 1) ? argv[type_arg + 1] : "none";
+        RadixPayload payload = RadixPayload::None;
+        if (payload_name == "payload32")
+        {
+            payload = RadixPayload::Payload32;
+        }
+        else if (payload_name == "payload64")
+        {
+            payload = RadixPayload::Payload64;
+        }
+        else if (payload_name == "argsort")
+        {
+            payload = RadixPayload::ArgSort;
+        }
+        bool sorted = false;
+        if (segments)
+        {
+            // the segment is folded above a 32-bit radix key
+            if (key_type == "int")
+            {
+                sorted = sortSegments<cl_int>(context, device, queue, kernel_source_string, length, max_segment_length, payload);
+            }
+            else if (key_type == "float")
+            {
+                sorted = sortSegments<cl_float>(context, device, queue, kernel_source_string, length, max_segment_length, payload);
+            }
+            else
+            {
+                sorted = sortSegments<cl_uint>(context, device, queue, kernel_source_string, length, max_segment_length, payload);
+            }
+        }
+        else if (key_type == "int")
+        {
+            sorted = sortKeys(context, device, queue, kernel_source_string, randomKeys<cl_int>(length), payload);
+        }
+        else if (key_type == "long")
+        {
+            sorted = sortKeys(context, device, queue, kernel_source_string, randomKeys<cl_long>(length), payload);
+        }
+        else if (key_type == "ulong")
+        {
+            sorted = sortKeys(context, device, queue, kernel_source_string, randomKeys<cl_ulong>(length), payload);
+        }
+        else if (key_type == "timestamps")
+        {
+            sorted = sortKeys(context, device, queue, kernel_source_string, randomTimestamps(length), payload);
+        }
+        else if (key_type == "float")
+        {
+            sorted = sortKeys(context, device, queue, kernel_source_string, randomKeys<cl_float>(length), payload);
+        }
+        else if (key_type == "double")
+        {
+            sorted = sortKeys(context, device, queue, kernel_source_string, randomKeys<cl_double>(length), payload);
+        }
+        else
+        {
+            sorted = sortKeys(context, device, queue, kernel_source_string, randomKeys<cl_uint>(length), payload);
+        }
+        std::cout << length << " " << key_type << " keys (payload: " << payload_name << ") sorted: " << (sorted ? "yes" : "no") << std::endl;
+
+        clReleaseCommandQueue(queue);
+        clReleaseContext(context);
+        return 0;
+    }
+
     const char* kernel_source = kernel_source_string.c_str();
     program = clCreateProgramWithSource(context, 1, &kernel_source, NULL, &err);
     CHECK_CL_ERROR(err, "Couldn't create the program");
@@ -51,10 +448,6 @@ int main()
     std::vector<int> host_data = data;  // copy
     const size_t length = host_data.size();
     const size_t size_in_byte = length * sizeof(decltype(host_data.at(0)));
-    const int max_num = *std::max_element(host_data.cbegin(), host_data.cend());
-    const int min_num = *std::min_element(host_data.cbegin(), host_data.cend());
-    assert (max_num > 0 && min_num >= 0 && "Numbers must be non-negative and max num must be positive");
-    const int max_digit = int(std::log10(max_num)) + 1;
     
     assert((length > 0) && ((length & (length-1)) == 0) && "Invalid Length: length must be positive and a power of two");
     // create buffer(s)
@@ -71,10 +464,9 @@ int main()
     // set kernel args
     err = clSetKernelArg(kernel_radix_sort, 0, sizeof(cl_mem), &device_data);
     CHECK_CL_ERROR(err, "Couldn't set arg 1");
-    clSetKernelArg(kernel_radix_sort, 1, sizeof(length), &length);
+    const cl_int n = static_cast<cl_int>(length);  // the kernel takes an int
+    err = clSetKernelArg(kernel_radix_sort, 1, sizeof(n), &n);
     CHECK_CL_ERROR(err, "Couldn't set arg 2");
-    clSetKernelArg(kernel_radix_sort, 2, sizeof(max_digit), &max_digit);
-    CHECK_CL_ERROR(err, "Couldn't set arg 3");
 
     // set global and local sizes (grid and block sizes)
     size_t global_size = 32u;
@@ -0,0 +1,525 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "common.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define RADIX_BITS 4  // must match the value in kernels.clh
+#define RADIX_NUM_BUCKETS (1 << RADIX_BITS)
+#define RADIX_TILE_LENGTH 1024  // default of kernels.clh, lowered when the tile doesn't fit in local memory
+#define RADIX_GROUP_SIZE 256  // at most MAX_WORK_GROUP_SIZE of kernels.clh
+#define RADIX_GROUPS_PER_COMPUTE_UNIT 8
+
+/*
+what moves along with the keys
+*/
+enum class RadixPayload
+{
+    None,
+    Payload32,  // one cl_uint per key
+    Payload64,  // one cl_ulong per key
+    ArgSort     // the payload is output only and receives the sorting permutation (cl_int)
+};
+
+/*
+OpenCL C spelling of a key type, the unsigned integer type its digits are taken from and the order-preserving map
+to_radix of a key x to that type, definitions is prepended to the kernels (e.g. a pragma the key type needs)
+*/
+template <typename K>
+struct RadixKeyType;
+
+template <>
+struct RadixKeyType<cl_uint>
+{
+    static constexpr const char* name = "uint";
+    static constexpr const char* definitions = "";
+    static constexpr const char* radix_name = "uint";
+    static constexpr const char* to_radix = "(x)";
+};
+
+template <>
+struct RadixKeyType<cl_ulong>
+{
+    static constexpr const char* name = "ulong";
+    static constexpr const char* definitions = "";
+    static constexpr const char* radix_name = "ulong";
+    static constexpr const char* to_radix = "(x)";
+};
+
+// flipping the sign bit puts the negative keys first
+template <>
+struct RadixKeyType<cl_int>
+{
+    static constexpr const char* name = "int";
+    static constexpr const char* definitions = "";
+    static constexpr const char* radix_name = "uint";
+    static constexpr const char* to_radix = "(as_uint(x) ^ 0x80000000u)";
+};
+
+template <>
+struct RadixKeyType<cl_long>
+{
+    static constexpr const char* name = "long";
+    static constexpr const char* definitions = "";
+    static constexpr const char* radix_name = "ulong";
+    static constexpr const char* to_radix = "(as_ulong(x) ^ 0x8000000000000000ul)";
+};
+
+/*
+IEEE floats: flipping the sign bit of positive floats and all the bits of negative floats orders them as integers
+-0.0 is mapped to +0.0, so both zeros are equal and keep their order, and all NaNs go last, like BitonicKeyType
+*/
+template <>
+struct RadixKeyType<cl_float>
+{
+    static constexpr const char* name = "float";
+    static constexpr const char* definitions = "";
+    static constexpr const char* radix_name = "uint";
+    static constexpr const char* to_radix = "(isnan(x) ? 0xFFFFFFFFu : ((x) == 0.0f ? 0x80000000u : "
+                                            "(as_uint(x) ^ ((as_uint(x) >> 31) ? 0xFFFFFFFFu : 0x80000000u))))";
+};
+
+template <>
+struct RadixKeyType<cl_double>
+{
+    static constexpr const char* name = "double";
+    static constexpr const char* definitions = "#pragma OPENCL EXTENSION cl_khr_fp64 : enable";
+    static constexpr const char* radix_name = "ulong";
+    static constexpr const char* to_radix = "(isnan(x) ? 0xFFFFFFFFFFFFFFFFul : ((x) == 0.0 ? 0x8000000000000000ul : "
+                                            "(as_ulong(x) ^ ((as_ulong(x) >> 63) ? 0xFFFFFFFFFFFFFFFFul : 0x8000000000000000ul))))";
+};
+
+/*
+the kernels of the device-wide radix sort
+*/
+struct RadixSort
+{
+    cl_program program = NULL;
+    RadixPayload payload = RadixPayload::None;
+    cl_kernel kernel_clear_histograms = NULL;
+    cl_kernel kernel_histograms = NULL;
+    cl_kernel kernel_count = NULL;
+    cl_kernel kernel_scan = NULL;
+    cl_kernel kernel_scatter = NULL;
+    size_t key_size = 0;
+    size_t payload_size = 0;
+    int tile_length = 0;  // keys per tile of radixScatter
+    int num_bits = 0;  // bits of the radix key, one pass per RADIX_BITS of them
+    size_t local_size = 0;
+    size_t num_groups = 0;
+    cl_mem counts = NULL;  // RADIX_NUM_BUCKETS counts per work-group, scanned into offsets
+    cl_mem histograms = NULL;  // RADIX_NUM_BUCKETS counts per digit of the radix key, see radixDigitHistograms
+};
+
+static const size_t radix_payload_sizes[] = {0, sizeof(cl_uint), sizeof(cl_ulong), sizeof(cl_int)};
+
+/*
+builds the program of kernels.clh (kernel_source) for keys of type K with an optional payload and tiles of tile_length keys
+*/
+template <typename K>
+cl_program buildRadixProgram(cl_context context, cl_device_id device, const std::string& kernel_source,
+                             const RadixPayload payload, const int tile_length = RADIX_TILE_LENGTH)
+{
+    static const char* payload_options[] = {"", " -D PAYLOAD_T=uint", " -D PAYLOAD_T=ulong", " -D ARGSORT"};
+    const std::string options = std::string("-D KEY_T=") + RadixKeyType<K>::name + " -D RADIX_KEY_T=" + RadixKeyType<K>::radix_name +
+                                payload_options[static_cast<int>(payload)] + " -D RADIX_TILE_LENGTH=" + std::to_string(tile_length);
+    // the map is an expression of x, it's prepended to the kernels rather than passed as a build option
+    const std::string key_source_string = std::string(RadixKeyType<K>::definitions) + "\n#define TO_RADIX(x) ("
+                                          + RadixKeyType<K>::to_radix + ")\n";
+
+    cl_int err = CL_SUCCESS;
+    const char* sources[] = {key_source_string.c_str(), kernel_source.c_str()};
+    cl_program program = clCreateProgramWithSource(context, 2, sources, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radix sort program");
+    err = clBuildProgram(program, 1, &device, options.c_str(), NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't build the radix sort program");
+    return program;
+}
+
+/*
+builds the radix sort kernels (kernel_source is the content of radix-sort/include/kernels.clh) for keys of type K
+with an optional payload
+*/
+template <typename K = cl_uint>
+RadixSort createRadixSort(cl_context context, cl_device_id device, const std::string& kernel_source,
+                          const RadixPayload payload = RadixPayload::None)
+{
+    const size_t payload_size = radix_payload_sizes[static_cast<int>(payload)];
+
+    // radixScatter stages the keys and payloads of a tile twice (as read and sorted), next to the ranks and the scan
+    cl_ulong local_memory_size;
+    clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(local_memory_size), &local_memory_size, NULL);
+    const size_t other_local_bytes = RADIX_NUM_BUCKETS * RADIX_GROUP_SIZE * sizeof(cl_ushort) + RADIX_GROUP_SIZE * sizeof(cl_uint);
+    int tile_length = RADIX_TILE_LENGTH;
+    while (tile_length > RADIX_GROUP_SIZE && 2 * tile_length * (sizeof(K) + payload_size) + other_local_bytes > local_memory_size)
+    {
+        tile_length /= 2;
+    }
+
+    cl_int err = CL_SUCCESS;
+    RadixSort sort;
+    sort.payload = payload;
+    sort.key_size = sizeof(K);
+    sort.payload_size = payload_size;
+    sort.tile_length = tile_length;
+    sort.num_bits = 8 * sizeof(K);
+    sort.program = buildRadixProgram<K>(context, device, kernel_source, payload, tile_length);
+
+    sort.kernel_clear_histograms = clCreateKernel(sort.program, "radixClearHistograms", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radixClearHistograms kernel");
+    sort.kernel_histograms = clCreateKernel(sort.program, "radixDigitHistograms", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radixDigitHistograms kernel");
+    sort.kernel_count = clCreateKernel(sort.program, "radixCountDigits", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radixCountDigits kernel");
+    sort.kernel_scan = clCreateKernel(sort.program, "radixScanCounts", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radixScanCounts kernel");
+    sort.kernel_scatter = clCreateKernel(sort.program, "radixScatter", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radixScatter kernel");
+
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    sort.local_size = std::min<size_t>(RADIX_GROUP_SIZE, max_work_group_size);
+
+    // enough work-groups to fill the device, every work-group streams a long share of the keys
+    cl_uint compute_units;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(compute_units), &compute_units, NULL);
+    sort.num_groups = std::max<size_t>(1u, compute_units * RADIX_GROUPS_PER_COMPUTE_UNIT);
+
+    sort.counts = clCreateBuffer(context, CL_MEM_READ_WRITE, RADIX_NUM_BUCKETS * sort.num_groups * sizeof(cl_uint), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    sort.histograms = clCreateBuffer(context, CL_MEM_READ_WRITE, (sort.num_bits / RADIX_BITS) * RADIX_NUM_BUCKETS * sizeof(cl_uint),
+                                     NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    return sort;
+}
+
+/*
+shifts of the digits of the radix keys that differ between the n keys of data, the other digits are the same for all the keys
+radixDigitHistograms counts all the digits on the device in one read of the keys, only the histograms are read back,
+after the commands in the queue
+*/
+std::vector<cl_int> radixVaryingDigitShifts(cl_command_queue queue, const RadixSort& sort, cl_mem data, const cl_int n,
+                                            const cl_int tiles_per_group, const cl_int num_groups)
+{
+    cl_int err = CL_SUCCESS;
+    const size_t local_size = sort.local_size;
+    const size_t global_size = num_groups * local_size;
+
+    err = clSetKernelArg(sort.kernel_clear_histograms, 0, sizeof(cl_mem), &sort.histograms);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clEnqueueNDRangeKernel(queue, sort.kernel_clear_histograms, 1, NULL, &local_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the radixClearHistograms kernel");
+
+    err = clSetKernelArg(sort.kernel_histograms, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_histograms, 1, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_histograms, 2, sizeof(tiles_per_group), &tiles_per_group);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(sort.kernel_histograms, 3, sizeof(cl_mem), &sort.histograms);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clEnqueueNDRangeKernel(queue, sort.kernel_histograms, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the radixDigitHistograms kernel");
+
+    const int num_digits = sort.num_bits / RADIX_BITS;
+    std::vector<cl_uint> histograms(num_digits * RADIX_NUM_BUCKETS);
+    err = clEnqueueReadBuffer(queue, sort.histograms, CL_TRUE, 0, histograms.size() * sizeof(cl_uint), histograms.data(), 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't read the digit histograms");
+
+    // a digit with all the keys in one bucket doesn't need a pass
+    std::vector<cl_int> shifts;
+    for (int digit = 0; digit < num_digits; ++digit)
+    {
+        const auto histogram = histograms.cbegin() + digit * RADIX_NUM_BUCKETS;
+        if (*std::max_element(histogram, histogram + RADIX_NUM_BUCKETS) != static_cast<cl_uint>(n))
+        {
+            shifts.push_back(digit * RADIX_BITS);
+        }
+    }
+    return shifts;
+}
+
+/*
+enqueues the stable sort of the n keys of data by the num_bits lowest bits of their radix keys and returns the number of passes
+by default (num_bits < 0), the keys are sorted by all their bits, but the digits that are the same for all the keys
+are found on the device by radixVaryingDigitShifts (a short read back) and skipped, so keys of a narrow range
+or with common high bits need few passes whatever their width, otherwise nothing is read back
+scratch is a buffer of the same size as data, the passes go back and forth between the two and the result ends in data
+payload (n elements) moves with the keys, or receives the permutation for ArgSort, through payload_scratch of the same size
+both are ignored without a payload
+*/
+int enqueueRadixSort(cl_command_queue queue, const RadixSort& sort, cl_mem data, cl_mem scratch, const cl_int n,
+                     int num_bits = -1, cl_mem payload = NULL, cl_mem payload_scratch = NULL)
+{
+    assert((n > 0) && "Invalid Length: length must be positive");
+    assert((sort.payload == RadixPayload::None || (payload != NULL && payload_scratch != NULL)) &&
+           "This sort needs a payload buffer and its scratch buffer");
+    cl_int err = CL_SUCCESS;
+
+    // every work-group gets the same number of whole tiles
+    const cl_int num_tiles = (n + sort.tile_length - 1) / sort.tile_length;
+    const cl_int tiles_per_group = (num_tiles + static_cast<cl_int>(sort.num_groups) - 1) / static_cast<cl_int>(sort.num_groups);
+    const cl_int num_groups = (num_tiles + tiles_per_group - 1) / tiles_per_group;
+
+    std::vector<cl_int> shifts;
+    if (num_bits < 0)
+    {
+        shifts = radixVaryingDigitShifts(queue, sort, data, n, tiles_per_group, num_groups);
+    }
+    else
+    {
+        for (cl_int shift = 0; shift < std::min(num_bits, sort.num_bits); shift += RADIX_BITS)
+        {
+            shifts.push_back(shift);
+        }
+    }
+    // at least one pass, the first one writes the permutation of an argsort
+    if (shifts.empty())
+    {
+        shifts.push_back(0);
+    }
+    const cl_int num_counts = RADIX_NUM_BUCKETS * num_groups;
+    const size_t local_size = sort.local_size;
+    const size_t global_size = num_groups * local_size;
+
+    err = clSetKernelArg(sort.kernel_count, 1, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_count, 3, sizeof(tiles_per_group), &tiles_per_group);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clSetKernelArg(sort.kernel_count, 4, sizeof(cl_mem), &sort.counts);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+
+    err = clSetKernelArg(sort.kernel_scan, 0, sizeof(cl_mem), &sort.counts);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_scan, 1, sizeof(num_counts), &num_counts);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+
+    err = clSetKernelArg(sort.kernel_scatter, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(sort.kernel_scatter, 4, sizeof(tiles_per_group), &tiles_per_group);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+    err = clSetKernelArg(sort.kernel_scatter, 5, sizeof(cl_mem), &sort.counts);
+    CHECK_CL_ERROR(err, "Couldn't set arg 6");
+
+    // one pass per digit, the in-order queue keeps the passes in order
+    cl_mem input = data;
+    cl_mem output = scratch;
+    cl_mem input_payload = (sort.payload == RadixPayload::ArgSort) ? NULL : payload;
+    cl_mem output_payload = payload_scratch;
+    for (const cl_int shift : shifts)
+    {
+        err = clSetKernelArg(sort.kernel_count, 0, sizeof(cl_mem), &input);
+        CHECK_CL_ERROR(err, "Couldn't set arg 1");
+        err = clSetKernelArg(sort.kernel_count, 2, sizeof(shift), &shift);
+        CHECK_CL_ERROR(err, "Couldn't set arg 3");
+        err = clEnqueueNDRangeKernel(queue, sort.kernel_count, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the radixCountDigits kernel");
+
+        err = clEnqueueNDRangeKernel(queue, sort.kernel_scan, 1, NULL, &local_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the radixScanCounts kernel");
+
+        err = clSetKernelArg(sort.kernel_scatter, 0, sizeof(cl_mem), &input);
+        CHECK_CL_ERROR(err, "Couldn't set arg 1");
+        err = clSetKernelArg(sort.kernel_scatter, 1, sizeof(cl_mem), &output);
+        CHECK_CL_ERROR(err, "Couldn't set arg 2");
+        err = clSetKernelArg(sort.kernel_scatter, 3, sizeof(shift), &shift);
+        CHECK_CL_ERROR(err, "Couldn't set arg 4");
+        err = clSetKernelArg(sort.kernel_scatter, 6, sizeof(cl_mem), &input_payload);
+        CHECK_CL_ERROR(err, "Couldn't set arg 7");
+        err = clSetKernelArg(sort.kernel_scatter, 7, sizeof(cl_mem), &output_payload);
+        CHECK_CL_ERROR(err, "Couldn't set arg 8");
+        err = clEnqueueNDRangeKernel(queue, sort.kernel_scatter, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the radixScatter kernel");
+
+        std::swap(input, output);
+        // after the first pass of an argsort, input_payload is NULL and output_payload is payload_scratch
+        input_payload = output_payload;
+        output_payload = (input_payload == payload) ? payload_scratch : payload;
+    }
+
+    // an odd number of passes leaves the keys in scratch
+    if (input != data)
+    {
+        err = clEnqueueCopyBuffer(queue, input, data, 0, 0, n * sort.key_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't copy the sorted keys");
+        if (sort.payload != RadixPayload::None)
+        {
+            err = clEnqueueCopyBuffer(queue, input_payload, payload, 0, 0, n * sort.payload_size, 0, NULL, NULL);
+            CHECK_CL_ERROR(err, "Couldn't copy the sorted payload");
+        }
+    }
+    return static_cast<int>(shifts.size());
+}
+
+void releaseRadixSort(RadixSort& sort)
+{
+    clReleaseMemObject(sort.counts);
+    clReleaseMemObject(sort.histograms);
+    clReleaseKernel(sort.kernel_clear_histograms);
+    clReleaseKernel(sort.kernel_histograms);
+    clReleaseKernel(sort.kernel_count);
+    clReleaseKernel(sort.kernel_scan);
+    clReleaseKernel(sort.kernel_scatter);
+    clReleaseProgram(sort.program);
+    sort = RadixSort();
+}
+
+/*
+sort of many independent segments of keys of type K in one device-wide sort, see radixFoldSegments in kernels.clh
+the segment of every key is folded above its radix key, so K must have a 32-bit radix key (uint, int or float)
+*/
+struct SegmentedRadixSort
+{
+    cl_context context = NULL;
+    RadixSort folded_sort;  // argsort of the folded 64-bit keys
+    cl_program program = NULL;  // built for K, the other kernels of the program are unused
+    cl_kernel kernel_fold = NULL;
+    cl_kernel kernel_gather = NULL;
+    RadixPayload payload = RadixPayload::None;
+    size_t key_size = 0;
+    size_t payload_size = 0;
+    size_t local_size = 0;
+    size_t num_groups = 0;
+    // the buffers of the folded sort, allocated by the first sort that needs them and reused by the next ones
+    cl_int scratch_length = 0;
+    cl_mem folded_keys = NULL;
+    cl_mem folded_scratch = NULL;
+    cl_mem permutation = NULL;
+    cl_mem permutation_scratch = NULL;
+};
+
+template <typename K = cl_uint>
+SegmentedRadixSort createSegmentedRadixSort(cl_context context, cl_device_id device, const std::string& kernel_source,
+                                            const RadixPayload payload = RadixPayload::None)
+{
+    static_assert(sizeof(K) == 4, "The segment is folded above a 32-bit radix key");
+    cl_int err = CL_SUCCESS;
+    SegmentedRadixSort sort;
+    sort.context = context;
+    sort.payload = payload;
+    sort.key_size = sizeof(K);
+    sort.payload_size = radix_payload_sizes[static_cast<int>(payload)];
+    sort.folded_sort = createRadixSort<cl_ulong>(context, device, kernel_source, RadixPayload::ArgSort);
+    sort.local_size = sort.folded_sort.local_size;
+    sort.num_groups = sort.folded_sort.num_groups;
+
+    sort.program = buildRadixProgram<K>(context, device, kernel_source, payload);
+    sort.kernel_fold = clCreateKernel(sort.program, "radixFoldSegments", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radixFoldSegments kernel");
+    sort.kernel_gather = clCreateKernel(sort.program, "radixGatherSegments", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the radixGatherSegments kernel");
+    return sort;
+}
+
+void reserveSegmentedRadixSortScratch(SegmentedRadixSort& sort, const cl_int n)
+{
+    if (n <= sort.scratch_length)
+    {
+        return;
+    }
+    // the buffers are released once the commands that use them are done
+    for (cl_mem buffer : {sort.folded_keys, sort.folded_scratch, sort.permutation, sort.permutation_scratch})
+    {
+        if (buffer != NULL)
+        {
+            clReleaseMemObject(buffer);
+        }
+    }
+
+    cl_int err = CL_SUCCESS;
+    sort.folded_keys = clCreateBuffer(sort.context, CL_MEM_READ_WRITE, n * sizeof(cl_ulong), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    sort.folded_scratch = clCreateBuffer(sort.context, CL_MEM_READ_WRITE, n * sizeof(cl_ulong), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    sort.permutation = clCreateBuffer(sort.context, CL_MEM_READ_WRITE, n * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    sort.permutation_scratch = clCreateBuffer(sort.context, CL_MEM_READ_WRITE, n * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    sort.scratch_length = n;
+}
+
+/*
+enqueues the stable sort of every segment of the n keys of data independently and returns the number of passes
+segment_offsets (num_segments ints on the device) holds the start of every segment, the first one is 0 and the last one ends at n
+(as for enqueueBitonicSortSegments), but the segments can have any length and there can be millions of them:
+the cost is one fold, one sort of n folded keys and one gather, and the passes of the high digits of the segments
+above the last one are skipped like any constant digit (see radixVaryingDigitShifts), e.g. 2^20 segments of 32-bit keys
+take 13 passes
+payload (n elements) moves with the keys, or receives the permutation for ArgSort, it's ignored without a payload
+*/
+int enqueueSegmentedRadixSort(cl_command_queue queue, SegmentedRadixSort& sort, cl_mem data, const cl_int n,
+                              cl_mem segment_offsets, const cl_int num_segments, cl_mem payload = NULL)
+{
+    assert((n > 0) && "Invalid Length: length must be positive");
+    assert((num_segments > 0) && "There must be at least one segment");
+    assert((sort.payload == RadixPayload::None || payload != NULL) && "This sort needs a payload buffer");
+    reserveSegmentedRadixSortScratch(sort, n);
+
+    const size_t local_size = sort.local_size;
+    const size_t global_size = sort.num_groups * local_size;
+
+    cl_int err = clSetKernelArg(sort.kernel_fold, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_fold, 1, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_fold, 2, sizeof(cl_mem), &segment_offsets);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(sort.kernel_fold, 3, sizeof(num_segments), &num_segments);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clSetKernelArg(sort.kernel_fold, 4, sizeof(cl_mem), &sort.folded_keys);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+    err = clEnqueueNDRangeKernel(queue, sort.kernel_fold, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the radixFoldSegments kernel");
+
+    const int num_passes = enqueueRadixSort(queue, sort.folded_sort, sort.folded_keys, sort.folded_scratch, n, -1,
+                                            sort.permutation, sort.permutation_scratch);
+
+    // the folded keys aren't needed anymore, the keys and the payload are gathered in their buffers (of 8 bytes per key)
+    // and copied back
+    err = clSetKernelArg(sort.kernel_gather, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(sort.kernel_gather, 1, sizeof(cl_mem), &sort.folded_scratch);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(sort.kernel_gather, 2, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(sort.kernel_gather, 3, sizeof(cl_mem), &sort.permutation);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clSetKernelArg(sort.kernel_gather, 4, sizeof(cl_mem), &payload);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+    err = clSetKernelArg(sort.kernel_gather, 5, sizeof(cl_mem), &sort.folded_keys);
+    CHECK_CL_ERROR(err, "Couldn't set arg 6");
+    err = clEnqueueNDRangeKernel(queue, sort.kernel_gather, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the radixGatherSegments kernel");
+
+    err = clEnqueueCopyBuffer(queue, sort.folded_scratch, data, 0, 0, n * sort.key_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't copy the sorted keys");
+    if (sort.payload != RadixPayload::None)
+    {
+        err = clEnqueueCopyBuffer(queue, sort.folded_keys, payload, 0, 0, n * sort.payload_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't copy the sorted payload");
+    }
+    return num_passes;
+}
+
+void releaseSegmentedRadixSort(SegmentedRadixSort& sort)
+{
+    for (cl_mem buffer : {sort.folded_keys, sort.folded_scratch, sort.permutation, sort.permutation_scratch})
+    {
+        if (buffer != NULL)
+        {
+            clReleaseMemObject(buffer);
+        }
+    }
+    clReleaseKernel(sort.kernel_fold);
+    clReleaseKernel(sort.kernel_gather);
+    clReleaseProgram(sort.program);
+    releaseRadixSort(sort.folded_sort);
+    sort = SegmentedRadixSort();
+}
+
+#endif
@@ -0,0 +1,121 @@
+#include "include/Data.h"
+#include "include/common.h"
+#include "include/Reduction.h"
+#include <iostream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <vector>
+// OpenCL includes
+#include <CL/cl.h>
+
+int main()
+{
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue queue;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the queue");
+
+    // every operation is a separate program built from the same source
+    const auto file_name = "kernels.clh";
+    const auto kernel_source_string = readFile(file_name);
+
+    // read data
+    std::vector<int> host_data = data;  // copy
+    const int length = static_cast<int>(host_data.size());
+    const size_t size_in_byte = length * sizeof(decltype(host_data.at(0)));
+    assert((length > 0) && "Invalid Length: length must be positive");
+
+    // create buffer(s)
+    cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_ONLY, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    // one slot per operation, so all the reductions are read back at once
+    const int num_ops = 5;
+    cl_mem device_result_values = clCreateBuffer(context, CL_MEM_WRITE_ONLY, num_ops * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_result_indices = clCreateBuffer(context, CL_MEM_WRITE_ONLY, num_ops * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    // transfer data to GPU
+    clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+    const ReductionOp ops[num_ops] = {ReductionOp::Sum, ReductionOp::Min, ReductionOp::Max, ReductionOp::ArgMin, ReductionOp::ArgMax};
+    const std::string op_names[num_ops] = {"sum", "min", "max", "argmin", "argmax"};
+    std::vector<Reduction> reductions;
+    for (int op = 0; op < num_ops; ++op)
+    {
+        reductions.push_back(createReduction<cl_int>(context, device, kernel_source_string, ops[op]));
+        enqueueReduction(queue, reductions.back(), device_data, length, device_result_values, device_result_indices, op);
+    }
+
+    // wait until execution of the kernels is over
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // read the kernels' output
+    std::vector<cl_int> result_values(num_ops);
+    std::vector<cl_int> result_indices(num_ops);
+    clEnqueueReadBuffer(queue, device_result_values, CL_TRUE, 0, num_ops * sizeof(cl_int), result_values.data(), 0, NULL, NULL);
+    clEnqueueReadBuffer(queue, device_result_indices, CL_TRUE, 0, num_ops * sizeof(cl_int), result_indices.data(), 0, NULL, NULL);
+
+    // wait until data is compeletely read from device
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // Release resources
+    for (int op = 0; op < num_ops; ++op)
+    {
+        releaseReduction(reductions[op]);
+    }
+    clReleaseMemObject(device_data);
+    clReleaseMemObject(device_result_values);
+    clReleaseMemObject(device_result_indices);
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+
+    // write the result to disk, one operation per line (value and index for argmin/argmax)
+    const std::string output_file_name = "out.txt";
+    std::ofstream out(output_file_name);
+    if (out.is_open())
+    {
+        for (int op = 0; op < num_ops; ++op)
+        {
+            out << op_names[op] << " " << result_values[op];
+            if (ops[op] == ReductionOp::ArgMin || ops[op] == ReductionOp::ArgMax)
+            {
+                out << " " << result_indices[op];
+            }
+            out << "\n";
+        }
+        out.close();
+    }
+    else
+    {
+        std::cerr << "Couldn't open the output file" << std::endl;
+    }
+
+    return 0;
+}
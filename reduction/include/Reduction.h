@@ -0,0 +1,190 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include "common.h"
+#include <algorithm>
+#include <string>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define REDUCTION_GROUP_SIZE 256  // must match the value in kernels.clh
+#define REDUCTION_GROUPS_PER_COMPUTE_UNIT 4
+
+enum class ReductionOp
+{
+    Sum,
+    Min,
+    Max,
+    ArgMin,
+    ArgMax
+};
+
+/*
+OpenCL C spelling of a host type and of its identities for min and max
+*/
+template <typename T>
+struct ReductionType;
+
+template <>
+struct ReductionType<cl_int>
+{
+    static constexpr const char* name = "int";
+    static constexpr const char* min = "INT_MIN";
+    static constexpr const char* max = "INT_MAX";
+};
+
+template <>
+struct ReductionType<cl_uint>
+{
+    static constexpr const char* name = "uint";
+    static constexpr const char* min = "0";
+    static constexpr const char* max = "UINT_MAX";
+};
+
+template <>
+struct ReductionType<cl_long>
+{
+    static constexpr const char* name = "long";
+    static constexpr const char* min = "LONG_MIN";
+    static constexpr const char* max = "LONG_MAX";
+};
+
+template <>
+struct ReductionType<cl_ulong>
+{
+    static constexpr const char* name = "ulong";
+    static constexpr const char* min = "0";
+    static constexpr const char* max = "ULONG_MAX";
+};
+
+template <>
+struct ReductionType<cl_float>
+{
+    static constexpr const char* name = "float";
+    static constexpr const char* min = "-INFINITY";
+    static constexpr const char* max = "INFINITY";
+};
+
+template <>
+struct ReductionType<cl_double>
+{
+    static constexpr const char* name = "double";
+    static constexpr const char* min = "-INFINITY";
+    static constexpr const char* max = "INFINITY";
+};
+
+/*
+a reduction compiled for one element type and one operation
+the partials of the first pass live on the device for as long as the reduction does
+*/
+struct Reduction
+{
+    cl_program program = NULL;
+    cl_kernel kernel_first_pass = NULL;
+    cl_kernel kernel_final_pass = NULL;
+    cl_mem partial_values = NULL;
+    cl_mem partial_indices = NULL;
+    size_t local_size = 0;
+    size_t max_num_groups = 0;
+};
+
+/*
+builds the reduction kernels (kernel_source is the content of reduction/include/kernels.clh) for T and op
+*/
+template <typename T>
+Reduction createReduction(cl_context context, cl_device_id device, const std::string& kernel_source, const ReductionOp op)
+{
+    static const char* op_names[] = {"REDUCE_SUM", "REDUCE_MIN", "REDUCE_MAX", "REDUCE_ARGMIN", "REDUCE_ARGMAX"};
+    const std::string options = std::string("-D VALUE_T=") + ReductionType<T>::name +
+                                " -D VALUE_T_MIN=" + ReductionType<T>::min +
+                                " -D VALUE_T_MAX=" + ReductionType<T>::max +
+                                " -D REDUCE_OP=" + op_names[static_cast<int>(op)];
+
+    cl_int err = CL_SUCCESS;
+    Reduction reduction;
+    const char* source = kernel_source.c_str();
+    reduction.program = clCreateProgramWithSource(context, 1, &source, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the reduction program");
+    err = clBuildProgram(reduction.program, 1, &device, options.c_str(), NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't build the reduction program");
+
+    reduction.kernel_first_pass = clCreateKernel(reduction.program, "reduceFirstPass", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the reduceFirstPass kernel");
+    reduction.kernel_final_pass = clCreateKernel(reduction.program, "reduceFinalPass", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the reduceFinalPass kernel");
+
+    // the largest power of two that fits both the device and the local arrays
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    reduction.local_size = 1;
+    while (reduction.local_size * 2 <= std::min<size_t>(REDUCTION_GROUP_SIZE, max_work_group_size))
+    {
+        reduction.local_size *= 2;
+    }
+
+    // enough work-groups to fill the device, the rest of the input is covered by the grid-stride loop
+    cl_uint compute_units;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(compute_units), &compute_units, NULL);
+    reduction.max_num_groups = std::max<size_t>(1u, compute_units * REDUCTION_GROUPS_PER_COMPUTE_UNIT);
+
+    reduction.partial_values = clCreateBuffer(context, CL_MEM_READ_WRITE, reduction.max_num_groups * sizeof(T), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    reduction.partial_indices = clCreateBuffer(context, CL_MEM_READ_WRITE, reduction.max_num_groups * sizeof(cl_int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    return reduction;
+}
+
+/*
+enqueues the reduction of the n elements of data, nothing is read back
+result_values[result_offset] receives the result, result_indices[result_offset] the index of argmin/argmax
+(INT_MAX for the other operations)
+*/
+void enqueueReduction(cl_command_queue queue, const Reduction& reduction, cl_mem data, const cl_int n,
+                      cl_mem result_values, cl_mem result_indices, const cl_int result_offset = 0)
+{
+    const size_t groups_needed = (static_cast<size_t>(n) + reduction.local_size - 1) / reduction.local_size;
+    const cl_int num_groups = static_cast<cl_int>(std::max<size_t>(1u, std::min(groups_needed, reduction.max_num_groups)));
+
+    cl_int err = clSetKernelArg(reduction.kernel_first_pass, 0, sizeof(cl_mem), &data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(reduction.kernel_first_pass, 1, sizeof(n), &n);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(reduction.kernel_first_pass, 2, sizeof(cl_mem), &reduction.partial_values);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(reduction.kernel_first_pass, 3, sizeof(cl_mem), &reduction.partial_indices);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+
+    err = clSetKernelArg(reduction.kernel_final_pass, 0, sizeof(cl_mem), &reduction.partial_values);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(reduction.kernel_final_pass, 1, sizeof(cl_mem), &reduction.partial_indices);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(reduction.kernel_final_pass, 2, sizeof(num_groups), &num_groups);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(reduction.kernel_final_pass, 3, sizeof(cl_mem), &result_values);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clSetKernelArg(reduction.kernel_final_pass, 4, sizeof(cl_mem), &result_indices);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+    err = clSetKernelArg(reduction.kernel_final_pass, 5, sizeof(result_offset), &result_offset);
+    CHECK_CL_ERROR(err, "Couldn't set arg 6");
+
+    const size_t local_size = reduction.local_size;
+    const size_t first_pass_global_size = num_groups * local_size;
+    err = clEnqueueNDRangeKernel(queue, reduction.kernel_first_pass, 1, NULL, &first_pass_global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the reduceFirstPass kernel");
+    // the in-order queue runs the final pass after the first one
+    err = clEnqueueNDRangeKernel(queue, reduction.kernel_final_pass, 1, NULL, &local_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the reduceFinalPass kernel");
+}
+
+void releaseReduction(Reduction& reduction)
+{
+    clReleaseMemObject(reduction.partial_values);
+    clReleaseMemObject(reduction.partial_indices);
+    clReleaseKernel(reduction.kernel_first_pass);
+    clReleaseKernel(reduction.kernel_final_pass);
+    clReleaseProgram(reduction.program);
+    reduction = Reduction();
+}
+
+#endif
@@ -0,0 +1,201 @@
+#include "include/Data.h"
+#include "include/common.h"
+#include <iostream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define LOCAL_DATA_ARRAY_LENGTH 1024  // must match the value in kernels.clh
+
+int main()
+{
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+    cl_program program;
+    cl_command_queue queue;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the queue");
+
+    // create a program from kernel source code
+    const auto file_name = "kernels.clh";
+    const auto kernel_source_string = readFile(file_name);
+    const char* kernel_source = kernel_source_string.c_str();
+    program = clCreateProgramWithSource(context, 1, &kernel_source, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the program");
+    // build the program
+    clBuildProgram(program, 1, &device, NULL, NULL, NULL);
+
+    // read data
+    std::vector<int> host_data = data;  // copy
+    const int length = static_cast<int>(host_data.size());
+    const size_t size_in_byte = length * sizeof(decltype(host_data.at(0)));
+    const int num_segments = static_cast<int>(segment_offsets.size());
+    const size_t size_offsets_in_byte = num_segments * sizeof(decltype(segment_offsets.at(0)));
+    assert((length > 0) && "Invalid Length: length must be positive");
+    assert((num_segments > 0) && segment_offsets.front() == 0 && "The first segment must start at index 0");
+    assert(std::is_sorted(segment_offsets.cbegin(), segment_offsets.cend()) && "Segment offsets must be sorted");
+
+    // every work-group scans one block, the blocks are stitched together afterwards
+    const int num_blocks = (length + LOCAL_DATA_ARRAY_LENGTH - 1) / LOCAL_DATA_ARRAY_LENGTH;
+    const size_t size_blocks_in_byte = num_blocks * sizeof(int);
+
+    // create buffer(s)
+    cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_offsets = clCreateBuffer(context, CL_MEM_READ_ONLY, size_offsets_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    // head flags, block aggregates and first heads never leave the device
+    cl_mem device_head_flags = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_block_sums = clCreateBuffer(context, CL_MEM_READ_WRITE, size_blocks_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_block_flags = clCreateBuffer(context, CL_MEM_READ_WRITE, size_blocks_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_block_first_head = clCreateBuffer(context, CL_MEM_READ_WRITE, size_blocks_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    // transfer data to GPU
+    clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+    clEnqueueWriteBuffer(queue, device_offsets, CL_TRUE, 0, size_offsets_in_byte, segment_offsets.data(), 0, NULL, NULL);
+
+    // build kernel(s)
+    cl_kernel kernel_offsets_to_flags = clCreateKernel(program, "offsetsToHeadFlags", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the offsetsToHeadFlags kernel");
+    cl_kernel kernel_scan_blocks = clCreateKernel(program, "segmentedScanBlocks", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the segmentedScanBlocks kernel");
+    cl_kernel kernel_scan_block_sums = clCreateKernel(program, "segmentedScanBlockSums", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the segmentedScanBlockSums kernel");
+    cl_kernel kernel_add_carry = clCreateKernel(program, "segmentedScanAddCarry", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the segmentedScanAddCarry kernel");
+
+    // set kernel args
+    err = clSetKernelArg(kernel_offsets_to_flags, 0, sizeof(cl_mem), &device_offsets);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_offsets_to_flags, 1, sizeof(num_segments), &num_segments);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_offsets_to_flags, 2, sizeof(cl_mem), &device_head_flags);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(kernel_offsets_to_flags, 3, sizeof(length), &length);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+
+    err = clSetKernelArg(kernel_scan_blocks, 0, sizeof(cl_mem), &device_data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_scan_blocks, 1, sizeof(cl_mem), &device_head_flags);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_scan_blocks, 2, sizeof(length), &length);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(kernel_scan_blocks, 3, sizeof(cl_mem), &device_block_sums);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+    err = clSetKernelArg(kernel_scan_blocks, 4, sizeof(cl_mem), &device_block_flags);
+    CHECK_CL_ERROR(err, "Couldn't set arg 5");
+    err = clSetKernelArg(kernel_scan_blocks, 5, sizeof(cl_mem), &device_block_first_head);
+    CHECK_CL_ERROR(err, "Couldn't set arg 6");
+
+    err = clSetKernelArg(kernel_scan_block_sums, 0, sizeof(cl_mem), &device_block_sums);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_scan_block_sums, 1, sizeof(cl_mem), &device_block_flags);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_scan_block_sums, 2, sizeof(num_blocks), &num_blocks);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+    err = clSetKernelArg(kernel_add_carry, 0, sizeof(cl_mem), &device_data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_add_carry, 1, sizeof(length), &length);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_add_carry, 2, sizeof(cl_mem), &device_block_sums);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(kernel_add_carry, 3, sizeof(cl_mem), &device_block_first_head);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+
+    // set global and local sizes (grid and block sizes)
+    // one work-group per block, capped by what the device supports
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    size_t local_size = std::min<size_t>(256u, max_work_group_size);
+    size_t global_size = num_blocks * local_size;
+    size_t single_group_size = local_size;
+
+    // enqueue the kernels for execution, the in-order queue keeps them in sequence
+    err = clEnqueueNDRangeKernel(queue, kernel_offsets_to_flags, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the offsetsToHeadFlags kernel");
+    err = clEnqueueNDRangeKernel(queue, kernel_scan_blocks, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the segmentedScanBlocks kernel");
+    if (num_blocks > 1)
+    {
+        err = clEnqueueNDRangeKernel(queue, kernel_scan_block_sums, 1, NULL, &single_group_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the segmentedScanBlockSums kernel");
+        err = clEnqueueNDRangeKernel(queue, kernel_add_carry, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the segmentedScanAddCarry kernel");
+    }
+
+    // wait until execution of the kernels is over
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // read the kernel's output
+    clEnqueueReadBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+    // wait until data is compeletely read from device
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // Release resources
+    clReleaseMemObject(device_data);
+    clReleaseMemObject(device_offsets);
+    clReleaseMemObject(device_head_flags);
+    clReleaseMemObject(device_block_sums);
+    clReleaseMemObject(device_block_flags);
+    clReleaseMemObject(device_block_first_head);
+    clReleaseKernel(kernel_offsets_to_flags);
+    clReleaseKernel(kernel_scan_blocks);
+    clReleaseKernel(kernel_scan_block_sums);
+    clReleaseKernel(kernel_add_carry);
+    clReleaseProgram(program);
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+
+    // write the result to disk, one segment per line
+    const std::string output_file_name = "out.txt";
+    std::ofstream out(output_file_name);
+    if (out.is_open())
+    {
+        for (int segment = 0; segment < num_segments; ++segment)
+        {
+            const int begin = std::min(segment_offsets[segment], length);
+            const int end = (segment + 1 < num_segments) ? std::min(segment_offsets[segment + 1], length) : length;
+            std::copy(host_data.cbegin() + begin, host_data.cbegin() + end, std::ostream_iterator<int>(out, " "));
+            out << "\n";
+        }
+        out.close();
+    }
+    else
+    {
+        std::cerr << "Couldn't open the output file" << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
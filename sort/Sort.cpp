@@ -0,0 +1,263 @@
+#include "include/Data.h"
+#include "include/common.h"
+#include "include/Sort.h"
+#include <iostream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <random>
+#include <vector>
+// OpenCL includes
+#include <CL/cl.h>
+
+const std::string calibration_file_name = "sort_calibration.txt";
+
+/*
+length random keys of type K, the float keys get NaNs and both zeros mixed in, so an unstable sort shows
+*/
+template <typename K>
+std::vector<K> randomKeys(const size_t length)
+{
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    const K special_keys[] = {std::numeric_limits<K>::quiet_NaN(), K(0.0), K(-0.0)};
+    std::vector<K> keys(length);
+    for (K& key : keys)
+    {
+        if (std::is_floating_point<K>::value)
+        {
+            key = (generator() % 8 == 0) ? special_keys[generator() % 3] : static_cast<K>(distribution(generator));
+        }
+        else
+        {
+            key = static_cast<K>(generator());
+        }
+    }
+    return keys;
+}
+
+/*
+sorts length random keys of type K with a payload, with the backend the calibration picks and then with every backend,
+and checks every result against std::stable_sort, returns whether they all match
+*/
+template <typename K>
+bool sortRandomKeys(cl_context context, cl_device_id device, cl_command_queue queue, const SortKernelSources& sources,
+                    const cl_int length, const SortPayload payload)
+{
+    cl_int err = CL_SUCCESS;
+    Sorter sorter = createSorter<K>(context, device, sources, payload, calibration_file_name);
+    const std::vector<K> keys = randomKeys<K>(length);
+
+    // the payload of the i-th key is i, so the expected payload is the permutation of the stable sort (for all the kinds)
+    std::vector<cl_ulong> indices(length);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::vector<unsigned char> host_payload(length * sorter.payload_size);
+    for (cl_int i = 0; i < length && sorter.payload_size > 0; ++i)
+    {
+        std::memcpy(&host_payload[i * sorter.payload_size], &indices[i], sorter.payload_size);
+    }
+    std::vector<cl_ulong> permutation = indices;
+    std::stable_sort(permutation.begin(), permutation.end(), [&keys](const cl_ulong i, const cl_ulong j) {
+        return sortKeyLess(keys[i], keys[j]);
+    });
+    std::vector<K> expected_keys(length);
+    std::vector<unsigned char> expected_payload(length * sorter.payload_size);
+    for (cl_int i = 0; i < length; ++i)
+    {
+        expected_keys[i] = keys[permutation[i]];
+        if (sorter.payload_size > 0)
+        {
+            std::memcpy(&expected_payload[i * sorter.payload_size], &permutation[i], sorter.payload_size);
+        }
+    }
+
+    cl_mem device_keys = clCreateBuffer(context, CL_MEM_READ_WRITE, length * sizeof(K), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_payload = NULL;
+    if (payload != SortPayload::None)
+    {
+        device_payload = clCreateBuffer(context, CL_MEM_READ_WRITE, length * sorter.payload_size, NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    }
+
+    // the first run lets the sorter pick the backend, the next ones go through all the backends
+    bool all_sorted = true;
+    for (int run = -1; run < static_cast<int>(sizeof(sort_backends) / sizeof(sort_backends[0])); ++run)
+    {
+        const bool first_run = (run < 0);
+        if (!first_run && !sortBackendAvailable(sorter, sort_backends[run], length))
+        {
+            continue;
+        }
+        clEnqueueWriteBuffer(queue, device_keys, CL_TRUE, 0, length * sizeof(K), keys.data(), 0, NULL, NULL);
+        if (payload != SortPayload::None)
+        {
+            clEnqueueWriteBuffer(queue, device_payload, CL_TRUE, 0, host_payload.size(), host_payload.data(), 0, NULL, NULL);
+        }
+        const SortBackend used_backend = first_run ? enqueueSort(queue, sorter, device_keys, length, device_payload)
+                                                   : enqueueSortWith(queue, sorter, sort_backends[run], device_keys, length, device_payload);
+        err = clFinish(queue);
+        CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+        std::vector<K> sorted_keys(length);
+        std::vector<unsigned char> sorted_payload(length * sorter.payload_size);
+        clEnqueueReadBuffer(queue, device_keys, CL_TRUE, 0, length * sizeof(K), sorted_keys.data(), 0, NULL, NULL);
+        if (payload != SortPayload::None)
+        {
+            clEnqueueReadBuffer(queue, device_payload, CL_TRUE, 0, sorted_payload.size(), sorted_payload.data(), 0, NULL, NULL);
+        }
+        // compares the bits, so every backend must keep the order of -0.0 and +0.0
+        const bool sorted = std::memcmp(sorted_keys.data(), expected_keys.data(), length * sizeof(K)) == 0 &&
+                            sorted_payload == expected_payload;
+        std::cout << (first_run ? "picked " : "") << sort_backend_names[static_cast<int>(used_backend)] << ": "
+                  << length << " keys sorted: " << (sorted ? "yes" : "no") << std::endl;
+        all_sorted = all_sorted && sorted;
+    }
+
+    if (device_payload != NULL)
+    {
+        clReleaseMemObject(device_payload);
+    }
+    clReleaseMemObject(device_keys);
+    releaseSorter(sorter);
+    return all_sorted;
+}
+
+/*
+stores the timings of all the backends for keys of type K with a payload in the calibration file
+*/
+template <typename K>
+void calibrate(cl_context context, cl_device_id device, cl_command_queue queue, const SortKernelSources& sources,
+               const cl_int max_length, const SortPayload payload)
+{
+    Sorter sorter = createSorter<K>(context, device, sources, payload);
+    calibrateSorter<K>(queue, sorter, max_length, calibration_file_name);
+    for (const SortTiming& timing : sorter.timings)
+    {
+        std::cout << sort_backend_names[static_cast<int>(timing.backend)] << " " << timing.length << " keys: "
+                  << timing.seconds * 1e6 << " us" << std::endl;
+    }
+    releaseSorter(sorter);
+}
+
+/*
+calls f<K>(args...) for the key type named type_name (int by default, uint, long, ulong, float or double)
+*/
+#define DISPATCH_KEY_TYPE(type_name, f, ...)                                  \
+    ((type_name) == "uint" ? f<cl_uint>(__VA_ARGS__) :                       \
+     (type_name) == "long" ? f<cl_long>(__VA_ARGS__) :                       \
+     (type_name) == "ulong" ? f<cl_ulong>(__VA_ARGS__) :                     \
+     (type_name) == "float" ? f<cl_float>(__VA_ARGS__) :                     \
+     (type_name) == "double" ? f<cl_double>(__VA_ARGS__) : f<cl_int>(__VA_ARGS__))
+
+SortPayload payloadByName(const std::string& name)
+{
+    for (int payload = 0; payload < 4; ++payload)
+    {
+        if (name == sort_payload_names[payload])
+        {
+            return static_cast<SortPayload>(payload);
+        }
+    }
+    return SortPayload::None;
+}
+
+/*
+sorts the keys of Data.h with the backend the calibration picks
+or argv[1] random keys of type argv[2] (int by default, uint, long, ulong, float or double) with payload argv[3]
+(none by default, payload32, payload64 or argsort) with the picked backend and then with every backend
+with --calibrate, times all the backends up to argv[2] keys (2^22 by default) for key type argv[3] and payload argv[4]
+and stores the timings in sort_calibration.txt, where the next runs on the same device pick their backend from
+*/
+int main(int argc, char** argv)
+{
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue queue;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the queue");
+
+    // the kernels of the backends, from their projects
+    SortKernelSources sources;
+    sources.bitonic = readFile("../../bitonic-sort/include/kernels.clh");
+    sources.radix = readFile("../../radix-sort/include/kernels.clh");
+    sources.merge = readFile("../../merge-sort/include/kernels.clh");
+
+    if (argc > 1 && std::string(argv[1]) == "--calibrate")
+    {
+        const cl_int max_length = (argc > 2) ? std::stoi(argv[2]) : (1 << 22);
+        const std::string key_type = (argc > 3) ? argv[3] : "int";
+        const SortPayload payload = payloadByName((argc > 4) ? argv[4] : "none");
+        DISPATCH_KEY_TYPE(key_type, calibrate, context, device, queue, sources, max_length, payload);
+    }
+    else if (argc > 1)
+    {
+        const cl_int length = std::stoi(argv[1]);
+        assert((length > 0) && "Invalid Length: length must be positive");
+        const std::string key_type = (argc > 2) ? argv[2] : "int";
+        const SortPayload payload = payloadByName((argc > 3) ? argv[3] : "none");
+        const bool sorted = DISPATCH_KEY_TYPE(key_type, sortRandomKeys, context, device, queue, sources, length, payload);
+        std::cout << length << " " << key_type << " keys sorted by every backend: " << (sorted ? "yes" : "no") << std::endl;
+    }
+    else
+    {
+        // read data
+        std::vector<int> host_data = data;  // copy
+        const size_t length = host_data.size();
+        const size_t size_in_byte = length * sizeof(decltype(host_data.at(0)));
+        assert((length > 0) && "Invalid Length: length must be positive");
+
+        Sorter sorter = createSorter<cl_int>(context, device, sources, SortPayload::None, calibration_file_name);
+        cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_WRITE, size_in_byte, NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+        clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+        const SortBackend backend = enqueueSort(queue, sorter, device_data, static_cast<cl_int>(length));
+        clEnqueueReadBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+        std::cout << length << " keys sorted by " << sort_backend_names[static_cast<int>(backend)] << ": "
+                  << (std::is_sorted(host_data.cbegin(), host_data.cend()) ? "yes" : "no") << std::endl;
+
+        clReleaseMemObject(device_data);
+        releaseSorter(sorter);
+
+        // write the result to disk
+        const std::string output_file_name = "out.txt";
+        std::ofstream out(output_file_name);
+        if (out.is_open())
+        {
+            // copy the content of host_data to disk
+            std::copy(host_data.cbegin(), host_data.cend(), std::ostream_iterator<int>(out, " "));
+            out.close();
+        }
+        else
+        {
+            std::cerr << "Couldn't open the output file" << std::endl;
+        }
+    }
+
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+    return 0;
+}
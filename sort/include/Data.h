@@ -0,0 +1,137 @@
+#ifndef DATA_H
+#define DATA_H
+
+#include <vector>
+
+inline std::vector<int> data = 
+                    {      -975,   -39,  -770,   564,  -196,  -712,   400,  -912,  -716,   946,  -770,    96,  -526,   457,   551,  -715,
+                           -699,   516,  -933,   356,  -876,  -721,  -527,    97,   499,   -84,    77,  -156,  -581,   214,  -810,  -759,
+                           -959,   577,   924,   817,  -175,  -301,  -594,  -579,  -324,  -198,  -253,   222,   956,  -496,  -570,   482,
+                           -556,  -148,   197,   357,   121,  -878,   953,  -895,   717,  -632,  -272,  -725,  -583,  -698,   712,   630,
+                           -230,  -938,  -824,   505,    87,   778,  -102,   333,   656,  -553,  -575,   631,  -115,   494,  -248,  -604,
+                           -323,   312,   676,  -552,   -13,  -916,  -461,  -312,  -400,  -316,   171,  -189,   -14,   324,   332,   712,
+                           -353,   968,  -564,   999,   534,  -805,   617,   582,  -373,   835,  -639,   146,   277,   916,   117,   716,
+                            381,  -396,  -809,  -645,  -606,  -942,   886,   625,   231,  -233,   424,   959,  -805,   371,  -183,  -417,
+                            863,  -375,   329,   718,   812,  -597,  -767,   -69,  -586,   639,  -317,   -90,  -175,   615,  -901,   150,
+                            462,  -759,  -452,  -798,   788,   304,  -756,   967,  -603,  -589,  -314,  -668,   461,   749,  -689,   -26,
+                           -882,    20,   252,   614,    48,  -431,   762,  -238,   254,     4,   302,   209,  -923,   750,  -771,    -6,
+                           -718,   632,   485,   241,   419,    19,   993,   698,   571,  -950,  -479,     3,   567,   600,   -38,  -286,
+                           -514,  -978,  -802,  -232,   193,  -422,   -87,  -640,  -908,  -730,  -745,   161,   771,   257,  -898,   891,
+                            257,   816,  -578,   615,  -605,   938,   680,   774,  -389,   411,  -624,   135,   -69,   143,   423,    51,
+                             73,   453,   760,    31,  -178,  -536,    73,  -602,   468,   258,   -55,  -369,   468,   677,   -44,  -333,
+                           -727,  -240,  -748,    70,   603,  -290,   525,  -608,   930,  -401,   413,  -224,   187,   582,  -660,  -914,
+                            747,   368,  -757,   500,  -130,  -575,  -712,  -498,  -221,   807,  -371,  -581,  -129,   823,   456,  -372,
+                            109,   202,  -503,   882,   595,  -449,   505,   923,   694,  -923,  -933,   -33,   258,   695,   833,  -439,
+                           -470,    98,  -586,  -110,   666,   437,  -255,  -569,  -179,  -932,   674,   -92,  -214,   448,  -594,  -509,
+                           -561,  -341,  -293,  -392,   429,   964,  -246,  -770,   579,  -558,  -865,   984,  -490,   812,   279,   420,
+                            -18,   819,    23,   -75,   915,   335,  -432,   348,  -629,  -145,  -931,  -861,   -12,  -685,  -392,   655,
+                            -30,   703,  -989, -1000,  -433,  -223,  -442,   551,  -418,  -385,   821,   868,  -497,   186,  -371,  -174,
+                            830,   591,   985,  -523,  -511,   239,  -709,   733,   295,   107,   573,  -346,   740,  -804,   372,   175,
+                            449,  -616,  -958,  -236,   856,   110,     8,   927,  -374,   379,   -40,    63,   924,   757,  -469,  -368,
+                            620,  -207,  -185,   386,  -563,   135,   815,  -547,   571,  -159,  -902,   686,   168,  -504,   964,   445,
+                           -510,  -902,   736,   955,  -158,   400,   868,  -338,  -442,  -779,   631,   125,  -874,  -329,  -492,   493,
+                              6,   557,  -125,  -712,   568,  -903,  -368,  -360,   635,  -909,   913,  -163,  -539,   102,   764,   -98,
+                            118,  -711,  -844,  -953,    10,   644,   -31,   -99,  -444,   -17,   553,   -21,   366,   404,  -994,   844,
+                            390,   693,   489,   330,  -306,  -519,  -655,  -817,   -48,   759,  -265,  -884,   917,   165,  -198,   863,
+                            781,  -341,   267,  -204,  -586,  -144,  -552,   934,  -882,   401,   780,   717,   -87,  -921,   808,   495,
+                           -156,   -77,   539,  -178,  -722,   672,   976,   505,   611,   864,   957,   512,    57,   863,  -348,  -124,
+                           -510,   138,  -473,   607,  -814,   -72,  -886,  -719,   783,   199,  -372,   784,   452,   782,  -599,  -744,
+                            320,  -220,   -41,  -532,  -437,  -302,  -303,   965,   882,  -138,   586,  -359,   708,  -442,   224,   -99,
+                            680,   371,  -140,  -299,  -859,  -619,   334,  -537,   836,  -468,   664,   855,   976,  -653,  -762,   544,
+                            743,  -779,   450,   609,  -365,  -456,   361,   596,   -78,  -116,  -598,  -840,    43,  -807,  -317,   638,
+                            843,   109,   782,    -5,   -24,  -279,  -707,   415,  -107,   -13,  -681,  -873,  -477,   230,  -342,  -358,
+                            744,   733,  -370,   124,  -879,   584,  -335,  -754,   412,   448,   728,   250,   674,   742,   429,   810,
+                           -533,   129,    44,   212,   197,   570,  -636,  -460,  -713,   115,  -378,   611,  -204,   217,   -97,   111,
+                           -350,   752,   240,   997,   382,  -470,   532,  -847,   323,   256,  -656,  -696,   408,   985,  -708,   -29,
+                            966,    93,   476,   673,   471,   781,   515,  -709,  -128,   -72,   979,  -631,  -648,   -57,    49,  -728,
+                            397,   796,   197,  -272,   640,  -203,    -1,   838,  -592,   686,   -13,  -312,  -974,    23,  -239,   358,
+                            561,  -616,   475,  -722,   -11,   756,  -370,  -669,  -576,   449,  -805,   511,   -56,   211,    17,  -292,
+                            929,   756,  -726,   610,   875,  -855,   543,   837,   856,   303,   228,  -408,   666,  -655,  -867,  -800,
+                           -962,   661,  -895,   736,  -288,   160,  -632,  -513,  -850,  -242,  -153,  -150,  -391,    56,  -894,   972,
+                           -391,  -181,   681,  -799,  -867,  -803,  -173,  -665,    53,  -398,  -669,   330,  -926,  -296,  -848,   111,
+                           -706,  -191,   995,  -412,   765,   571,   444,   500,   842,  -794,  -334,  -499,  -490,   748,   781,   979,
+                            241,   -33,   891,   588,  -265,    68,  -155,  -125,   470,   807,   327,  -661,  1000,  -462,   456,  -972,
+                            293,   146,  -507,   891,  -561,   162,  -964,  -696,   494,   415,   231,   330,   373,  -785,   838,   872,
+                           -425,   351,  -615,     4,  -537,  -296,   -66,  -672,  -410,   -43,   431,  -252,   922,  -523,  -432,   323,
+                           -269,   355,   960,   954,  -455,   983,   815,   -46,  -298,   466,   323,  -232,  -590,  -113,  -151,   161,
+                            104,   488,  -915,  -967,   -52,    92,  -312,    85,   648,   215,   946,   697,   -34,  -137,  -837,    45,
+                            217,   436,   203,   943,   394,   753,   590,   571,   -52,     5,   124,    75,   571,   132,  -944,  -999,
+                           -509,    31,   408,  -897,  -194,   931,   766,  -423,   542,   991,  -187,  -429,  -821,   -73,  -498,  -675,
+                            -88,   234,  -500,  -198,  -618,   403,     9,   960,  -529,  -739,   224,   346,   516,   232,    97,  -439,
+                           -300,  -928,  -467,   923,  -439,   423,   280,   763,  -791,  -948,   843,  -189,  -183,  -913,   -48,   375,
+                            139,  -807,   -87,  -763,   952,    38,   -43,   309,   387,  -213,   582,  -381,   910,   638,  -652,  -853,
+                           -305,  -241,   945,  -668,   241,  -412,  -237,  -444,   805,  -742,  -757,  -688,  -482,   166,  -859,  -861,
+                            373,  -558,    -4,  -907,  -377,   121,  -100,  -555,  -482,  -792,   452,  -893,   555,   165,  -219,    71,
+                            779,  -884,  -909,  -933,   158,  -593,  -686,  -474,  -760,   -85,   143,  -836,  -822,  -869,  -848,   719,
+                           -726,  -340,  -229,   599,   700,  -409,  -333,  -750,   682,   572,  -244,   673,   266,   885,  -900,   779,
+                           -662,   796,  -113,   727,   809,   105,   809,    17,  -541,   336,   -37,   610,   406,   820,  -536,   154,
+                             69,   320,   689,  -952,   670,  -885,   426,   157,   697,  -282,   895,   239,    63,  -490,   277,  -546,
+                           -697,  -885,   -70,   881,  -703,   170,   162,   234,   791,   787,  -770,   414,   103,  -197,   281,   199,
+                           -237,  -832,   545,  -482,   -14,  -297,    82,   627,  -403,   354,   121,   236,   880,  -191,    35,  -280,
+                           -802,  -213,   147,  -898,  -692,  -262,  -997,   862,  -691,   669,   540,  -490,  -764,    21,  -726,   525,
+                            591,  -591,   388,  -271,   722,   201,   642,  -616,   441,   862,  -300,  -962,   681,   804,  -469,   370,
+                           -432,  -187,  -223,  -410,   658,   778,    68,   457,  -238,  -569,   817,  -350,  -597,  -810,   425,   287,
+                            398,  -133,   182,  -350,   766,   441,   315,  -480,   113,  -710,   923,   630,   344,   816,   588,   653,
+                           -510,   144,   -51,   468,  -872,   767,   446,  -921,    67,  -387,   751,  -272,   432,   501,    53,  -312,
+                            221,   564,  -487,  -473,  -276,   938,    33,  -109,   190,   209,  -983,   286,   237,   682,   662,   154,
+                            983,  -567,   -98,   894,   152,  -351,  -852,    64,   697,   333,  -371,   808,   885,  -332,  -239,  -174,
+                            947,  -981,   478,   737,  -195,  -935,   436,   287, -1000,  -827,   219,   194,   530,  -370,  -553,  -167,
+                           -129,   444,   864,   -31,  -109,   253,  -343,   519,   509,   711,  -636,  -784,   242,   697,   695,   521,
+                           -896,  -535,   268,  -828,   837,  -605,  -213,  -817,  -112,   168,    56,   447,    -5,   388,  -435,    91,
+                           -652,   398,   992,  -806,   119,   326,  -512,  -122,   865,  -266,  -144,   396,  -875,    46,  -425,  -481,
+                            726,  -618,   798,  -967,   499,   667,   776,  -329,   182,   491,  -800,   723,  -305,  -177,   138,    45,
+                            729,   477,  -696,   315,   254,  -257,   278,  -594,   535,  -417,   314,  -958,   320,   301,  -132,   312,
+                            748,   584,  -658,  -100,   210,   498,  -660,   145,   785,   744,    51,   127,   952,   378,   966,   228,
+                           -413,  -585,   -50,  -843,   -53,   679,  -923,   417,   -53,    45,  -307,   871,  -370,  -628,   713,   500,
+                           -480,    30,  -160,  -785,   913,  -736,  -337,  -948,   673,  -613,   389,   591,   877,   -21,  -992,  -904,
+                           -235,    11,  -937,   992,   878,   612,   433,  -384,  -416,   -10,  -714,  -249,  -794,  -527,   951,   347,
+                           -500,  -953,  -221,   -31,   716,   899,   560,   549,  -503,   343,  -452,   703,   464,   949,  -300,  -447,
+                           -229,   937,  -708,   830,  -384,    12,  -340,  -723,  -279,    91,   622,    17,   753,  -601,  -497,  -293,
+                            470,  -414,   554,   714,   231,   165,  -418,   627,   856,   457,  -478,    32,   757,   338,   820,  -484,
+                             88,   986,  -894,  -437,  -443,  -534,  -864,   230,  -620,  -580,  -272,   605,   175,     3,   647,   964,
+                           -904,   -80,   524,  -885,  -775,   763,   460,  -576,  -979,  -270,   899,  -108,   791,   859,  -892,   374,
+                           -206,   820,   872,  -229,  -638,   -35,   -63,   271,  -465,   577,  -394,   213,     2,  -267,  -716,   585,
+                           -685,   696,   997,   424,   561,  -397,   223,   906,  -722,  -729,   392,   272,  -509,   258,   -58,  -980,
+                           -203,   973,   133,  -231,   790,  -450,    89,   301,   158,   872,  -814,  -284,   444,    45,   850,  -900,
+                              6,   -44,   332,   837,  -848,   926,  -284,   522,   762,   889,   277,  -380,   513,   751,   -65,  -426,
+                           -736,   975,  -500,   843,   988,  -283,  -165,  -983,   405,   724,   443,   207,   192,  -419,  -895,   655,
+                            364,   955,   644,  -193,   315,  -901,   849,   108,   973,    66,   311,   939,  -271,   912,    38,  -591,
+                           -628,  -544,  -139,  -622,   -96,  -501,   -43,  -544,   817,   610,   632,  -526,  -909,  -800,  -156,   704,
+                             89,   535,  -515,  -628,   566,  -807,   268,  -216,   738,   -31,  -725,   -15,  -617,   423,  -375,   187,
+                             59,   497,  -479,  -959,    52,  -442,  -291,  -581,  -873,  -202,   691,   488,   109,   305,   844,  -940,
+                             64,   -81,   761,   452,   248,   535,    15,   624,   923,  -225,  -261,     1,   281,   204,   483,   943,
+                           -669,  -809,  1000,   104,  -733,  -355,    89,   675,   104,   865,  -644,   760,  -904,  -206,   -97,  -851,
+                            485,   995,  -705,  -578,   655,   691,  -215,   212,  -836,   497,   823,   447,   308,  -515,  -619,  -210,
+                           -793,  -213,  -982,   440,  -274,   392,   255,  -855,   101,  -810,  -284,    65,  -755,   889,   -95,  -652,
+                            219,    23,   409,   863,  -943,    54,  -597,   555,   303,  -215,   608,   185,   929,   380,  -718,   981,
+                            491,    24,   -82,   556,   209,   742,   400,  -483,  -167,   470,   242,  -931,   978,  -918,  -956,   -59,
+                            128,  -287,  -282,   793,   873,  -487,   729,   602,  -892,   871,   693,  -162,  -837,   126,   695,  -397,
+                           -985,  -622,   580,   435,   211,   736,   996,  -450,   744,   123,  -112,  -950,   921,  -877,   756,  -303,
+                           -139,  -411,  -233,  -724,  -328,   829,  -336,  -442,   168,  -987,  -148,   284,   963,   365,  -999,   690,
+                            237,  -392,  -119,   694,   -77,   -18,   461,   954,   493,   342,  -223,  -774,   429,  -512,  -502,   247,
+                            669,   454,   177,  -747,  -527,   131,  -569,   329,  -204,   910,  -293,  -814,   361,   776,   -50,   -62,
+                           -931,  -702,  -334,   633,   -72,   -56,   936,   896,   685,   261,  -450,   975,  -249,  -691,  -136,  -578,
+                            685,  -691,  -960,  -476,   323,  -426,  -100,   105,  -965,   816,   340,  -277,  -962,  -339,  -798,   -34,
+                            262,   942,   -91,    37,  -713,  1000,  -370,   338,   130,  -506,   289,   940,   473,   816,   714,  -845,
+                           -756,   432,  -578,    88,  -784,  -946,   586,  -283,    11,   600,    10,   492,  -927,  -597,   639,  -516,
+                            988,   -74,  -972,  -114,   446,    -9,   397,  -759,   304,  -941,  -627,   435,   640,  -994,  -161,  -684,
+                            779,   760,  -994,   357,   780,  -735,  -676,  -245,  -619,  -564,  -313,   -69,  -324,   588,   840,  -182,
+                             33,   458,  -122,  -626,   662,   769,  -116,   543,  -363,    44,  -291,  -838,   192,   -56,   863,  -189,
+                            895,  -945,  -954,  -570,  -249,   225,   428,    15,   -15,   506,  -473,   920,  -725,  -907,  -277,   426,
+                           -959,  -508,  -353,   336,  -237,  -611,   855,  -713,  -202,   736,  -970,   342,  -466,   308,   -15,  -121,
+                           -348,  -479,  -323,  -871,  -980,   943,    68,   624,   388,   542,   418,  -840,  -722,  -976,   923,   -44,
+                           -519,  -794,  -629,   255,  -121,  -371,  -742,   593,  -509,  -663,   632,    21,   633,  -157,   156,  -524,
+                            583,  -323,  -332,  -610,  -891,  -381,   -95,  -874,  -198,  -943,   351,    49,   800,  -388,    33,  -711,
+                           -592,   445,    44,   476,  -692,  -598,   722,   715,  -969,  -962,  -422,   438,   898,   689,   191,  -505,
+                           -300,  -720,  -929,   881,  -634,    -7,   714,  -118,  -843,  -716,   423,   726,  -667,   -31,   551,  -145,
+                           -768,   586,  -734,   587,  -599,  -276,   947,  -920,  -964,  -957,   -23,   366,   860,  -243,   383,   -26,
+                           -969,   823,   357,   904,  -367,   172,  -547,   312,  -726,  -853,  -768,   162,   152,  -988,   547,   585,
+                            842,  -479,   306,   181,  -105,   295,   870,  -883,  -653,   435,   891,   780,   349,   106,  -718,   526,
+                           -130,   264,   405,   429,   665,   392,   912,   413,   686,   387,   147,    -9,   443,  -614,  -129,  -317,
+                           -353,  -332,   213,   407,    14,  -727,  -115,   417,   -48,   -34,   510,   889,   436,  -136,  -629,   530,
+                            138,  -704,   354,  -707,  -162,   744,  -258,   681,   301,  -501,   613,  -138,  -376,   562,  -831,   801,
+                            398,   207,   424,  -907,   946,   476,   192,   587,   118,  -761,   531,   674,   447,  -672,   -27,  -429,
+                           -775,   670,  -478,    12,   665,  -133,   385,   813,  -204,   735,  -304,  -390,   731,   714,   362,   330
+                    };
+
+#endif
\ No newline at end of file
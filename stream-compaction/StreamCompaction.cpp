@@ -0,0 +1,173 @@
+#include "include/Data.h"
+#include "include/common.h"
+#include <iostream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define LOCAL_DATA_ARRAY_LENGTH 1024  // must match the value in kernels.clh
+
+int main()
+{
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+    cl_program program;
+    cl_command_queue queue;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the queue");
+
+    // the predicate is an OpenCL C expression of x (the element), it is compiled into the kernels
+    const std::string predicate = "(x % 3) == 0";
+    const std::string predicate_source_string = "#define PREDICATE(x) (" + predicate + ")\n";
+
+    // create a program from the predicate and the kernel source code
+    const auto file_name = "kernels.clh";
+    const auto kernel_source_string = readFile(file_name);
+    const char* sources[] = {predicate_source_string.c_str(), kernel_source_string.c_str()};
+    program = clCreateProgramWithSource(context, 2, sources, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the program");
+    // build the program
+    err = clBuildProgram(program, 1, &device, NULL, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't build the program, check the predicate");
+
+    // read data
+    std::vector<int> host_data = data;  // copy
+    const int length = static_cast<int>(host_data.size());
+    const size_t size_in_byte = length * sizeof(decltype(host_data.at(0)));
+    assert((length > 0) && "Invalid Length: length must be positive");
+
+    // every work-group compacts one block
+    const int num_blocks = (length + LOCAL_DATA_ARRAY_LENGTH - 1) / LOCAL_DATA_ARRAY_LENGTH;
+
+    // create buffer(s)
+    cl_mem device_data = clCreateBuffer(context, CL_MEM_READ_ONLY, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    // block counts/offsets never leave the device
+    cl_mem device_block_offsets = clCreateBuffer(context, CL_MEM_READ_WRITE, num_blocks * sizeof(int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    cl_mem device_count = clCreateBuffer(context, CL_MEM_WRITE_ONLY, sizeof(int), NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    // worst case, every element survives
+    cl_mem device_out = clCreateBuffer(context, CL_MEM_WRITE_ONLY, size_in_byte, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    // transfer data to GPU
+    clEnqueueWriteBuffer(queue, device_data, CL_TRUE, 0, size_in_byte, host_data.data(), 0, NULL, NULL);
+
+    // build kernel(s)
+    cl_kernel kernel_count_blocks = clCreateKernel(program, "compactCountBlocks", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the compactCountBlocks kernel");
+    cl_kernel kernel_scan_block_counts = clCreateKernel(program, "compactScanBlockCounts", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the compactScanBlockCounts kernel");
+    cl_kernel kernel_scatter = clCreateKernel(program, "compactScatter", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the compactScatter kernel");
+
+    // set kernel args
+    err = clSetKernelArg(kernel_count_blocks, 0, sizeof(cl_mem), &device_data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_count_blocks, 1, sizeof(length), &length);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_count_blocks, 2, sizeof(cl_mem), &device_block_offsets);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+    err = clSetKernelArg(kernel_scan_block_counts, 0, sizeof(cl_mem), &device_block_offsets);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_scan_block_counts, 1, sizeof(num_blocks), &num_blocks);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_scan_block_counts, 2, sizeof(cl_mem), &device_count);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+    err = clSetKernelArg(kernel_scatter, 0, sizeof(cl_mem), &device_data);
+    CHECK_CL_ERROR(err, "Couldn't set arg 1");
+    err = clSetKernelArg(kernel_scatter, 1, sizeof(length), &length);
+    CHECK_CL_ERROR(err, "Couldn't set arg 2");
+    err = clSetKernelArg(kernel_scatter, 2, sizeof(cl_mem), &device_block_offsets);
+    CHECK_CL_ERROR(err, "Couldn't set arg 3");
+    err = clSetKernelArg(kernel_scatter, 3, sizeof(cl_mem), &device_out);
+    CHECK_CL_ERROR(err, "Couldn't set arg 4");
+
+    // set global and local sizes (grid and block sizes)
+    // one work-group per block, capped by what the device supports
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    size_t local_size = std::min<size_t>(256u, max_work_group_size);
+    size_t global_size = num_blocks * local_size;
+    size_t single_group_size = local_size;
+
+    // enqueue the kernels for execution, the in-order queue keeps them in sequence
+    err = clEnqueueNDRangeKernel(queue, kernel_count_blocks, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the compactCountBlocks kernel");
+    err = clEnqueueNDRangeKernel(queue, kernel_scan_block_counts, 1, NULL, &single_group_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the compactScanBlockCounts kernel");
+    err = clEnqueueNDRangeKernel(queue, kernel_scatter, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't launch the compactScatter kernel");
+
+    // only the number of survivors comes back, the compacted array stays on the device
+    int host_count = 0;
+    err = clEnqueueReadBuffer(queue, device_count, CL_TRUE, 0, sizeof(host_count), &host_count, 0, NULL, NULL);
+    CHECK_CL_ERROR(err, "Couldn't read the number of surviving elements");
+    std::cout << host_count << " out of " << length << " elements satisfy " << predicate << std::endl;
+
+    // the survivors are read here only to write them to disk
+    std::vector<int> host_out(host_count);
+    if (host_count > 0)
+    {
+        clEnqueueReadBuffer(queue, device_out, CL_TRUE, 0, host_count * sizeof(int), host_out.data(), 0, NULL, NULL);
+    }
+
+    // wait until data is compeletely read from device
+    err = clFinish(queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+
+    // Release resources
+    clReleaseMemObject(device_data);
+    clReleaseMemObject(device_block_offsets);
+    clReleaseMemObject(device_count);
+    clReleaseMemObject(device_out);
+    clReleaseKernel(kernel_count_blocks);
+    clReleaseKernel(kernel_scan_block_counts);
+    clReleaseKernel(kernel_scatter);
+    clReleaseProgram(program);
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+
+    // write the result to disk
+    const std::string output_file_name = "out.txt";
+    std::ofstream out(output_file_name);
+    if (out.is_open())
+    {
+        // copy the content of host_out to disk
+        std::copy(host_out.cbegin(), host_out.cend(), std::ostream_iterator<int>(out, " "));
+        out.close();
+    }
+    else
+    {
+        std::cerr << "Couldn't open the output file" << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "include/common.h"
+#include <iostream>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+// OpenCL includes
+#include <CL/cl.h>
+
+#define LOCAL_DATA_ARRAY_LENGTH 1024  // must match the value in kernels.clh
+#define NUM_SLOTS 2  // double buffering: one chunk is computed while the other one is transferred
+
+/*
+writes a test input of num_elements ints (1, 2, ..., 16, 1, 2, ...) to disk
+it is written in pieces so that it doesn't need to fit in host memory either
+*/
+void writeTestInput(const std::string& file_name, const size_t num_elements)
+{
+    std::ofstream out(file_name, std::ios::binary);
+    assert(out.is_open() && "Couldn't create the input file");
+    std::vector<int> piece(1 << 20);
+    for (size_t written = 0; written < num_elements; written += piece.size())
+    {
+        const size_t piece_length = std::min(piece.size(), num_elements - written);
+        for (size_t i = 0; i < piece_length; ++i)
+        {
+            piece[i] = static_cast<int>((written + i) % 16) + 1;
+        }
+        out.write(reinterpret_cast<const char*>(piece.data()), piece_length * sizeof(int));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // input is a binary file of ints, output a binary file of the (64-bit) running sums
+    const std::string input_file_name = (argc > 1) ? argv[1] : "in.bin";
+    const std::string output_file_name = (argc > 2) ? argv[2] : "out.bin";
+    const size_t num_test_elements = size_t(1) << 26;  // only used when the input file doesn't exist
+    size_t chunk_length = size_t(1) << 22;  // elements per chunk, clamped below to what the device allows
+
+    // initialize OpenCL
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform_id;
+    cl_device_id device;
+    cl_context context;
+    cl_program program;
+
+    clGetPlatformIDs(1, &platform_id, NULL);
+
+    // set the device
+    err = clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device, NULL);
+    if (err == CL_SUCCESS)
+    {
+        // at least one OpenCL capable GPU exists
+        std::cout << "GPU found" << std::endl;
+    }
+    else
+    {
+        // default to CPU
+        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_CPU, 1, &device, NULL);
+        std::cout << "No GPU found, switched back to CPU" << std::endl;
+    }
+
+    context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the context");
+    // separate in-order queues so that uploads, kernels and downloads of different chunks can overlap
+    cl_command_queue upload_queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the upload queue");
+    cl_command_queue compute_queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the compute queue");
+    cl_command_queue download_queue = clCreateCommandQueue(context, device, 0, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the download queue");
+
+    // create a program from kernel source code
+    const auto file_name = "kernels.clh";
+    const auto kernel_source_string = readFile(file_name);
+    const char* kernel_source = kernel_source_string.c_str();
+    program = clCreateProgramWithSource(context, 1, &kernel_source, NULL, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the program");
+    // build the program
+    clBuildProgram(program, 1, &device, NULL, NULL, NULL);
+
+    // map the input (create a test input first if there is none)
+    MappedFile input = openMappedFile(input_file_name);
+    if (input.data == nullptr)
+    {
+        std::cout << "Writing a test input of " << num_test_elements << " elements to " << input_file_name << std::endl;
+        writeTestInput(input_file_name, num_test_elements);
+        input = openMappedFile(input_file_name);
+    }
+    assert(input.data != nullptr && "Couldn't open the input file");
+    const size_t length = input.size / sizeof(int);
+    assert((length > 0) && "Invalid Length: length must be positive");
+    MappedFile output = createMappedFile(output_file_name, length * sizeof(cl_long));
+    const int* host_in = static_cast<const int*>(input.data);
+    cl_long* host_out = static_cast<cl_long*>(output.data);
+
+    // every slot holds one chunk of input and output on the device
+    cl_ulong max_alloc_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(max_alloc_size), &max_alloc_size, NULL);
+    chunk_length = std::min<size_t>(chunk_length, max_alloc_size / sizeof(cl_long));
+    chunk_length = std::min(chunk_length, length);
+    chunk_length = (chunk_length + LOCAL_DATA_ARRAY_LENGTH - 1) / LOCAL_DATA_ARRAY_LENGTH * LOCAL_DATA_ARRAY_LENGTH;
+    const size_t max_blocks_per_chunk = chunk_length / LOCAL_DATA_ARRAY_LENGTH;
+    const size_t num_chunks = (length + chunk_length - 1) / chunk_length;
+
+    // create buffer(s)
+    cl_mem device_in[NUM_SLOTS];
+    cl_mem device_out[NUM_SLOTS];
+    cl_mem device_block_sums[NUM_SLOTS];
+    for (int slot = 0; slot < NUM_SLOTS; ++slot)
+    {
+        device_in[slot] = clCreateBuffer(context, CL_MEM_READ_ONLY, chunk_length * sizeof(int), NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+        device_out[slot] = clCreateBuffer(context, CL_MEM_READ_WRITE, chunk_length * sizeof(cl_long), NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+        device_block_sums[slot] = clCreateBuffer(context, CL_MEM_READ_WRITE, max_blocks_per_chunk * sizeof(cl_long), NULL, &err);
+        CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+    }
+    // running sum of all the chunks processed so far, it stays on the device
+    const cl_long zero = 0;
+    cl_mem device_carry = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(zero), (void*)&zero, &err);
+    CHECK_CL_ERROR(err, "Couldn't create the buffer on the GPU");
+
+    // build kernel(s)
+    cl_kernel kernel_scan_blocks = clCreateKernel(program, "scanBlocks", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the scanBlocks kernel");
+    cl_kernel kernel_scan_block_sums = clCreateKernel(program, "scanBlockSums", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the scanBlockSums kernel");
+    cl_kernel kernel_add_block_offsets = clCreateKernel(program, "addBlockOffsets", &err);
+    CHECK_CL_ERROR(err, "Couldn't create the addBlockOffsets kernel");
+
+    // set global and local sizes (grid and block sizes)
+    size_t max_work_group_size;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_work_group_size), &max_work_group_size, NULL);
+    size_t local_size = std::min<size_t>(256u, max_work_group_size);
+    size_t single_group_size = local_size;
+
+    // events that order the three queues, one set per slot
+    cl_event uploaded[NUM_SLOTS] = {NULL, NULL};
+    cl_event computed[NUM_SLOTS] = {NULL, NULL};
+    cl_event downloaded[NUM_SLOTS] = {NULL, NULL};
+
+    const auto start_time = std::chrono::steady_clock::now();
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        const int slot = chunk % NUM_SLOTS;
+        const size_t chunk_start = chunk * chunk_length;
+        const int n = static_cast<int>(std::min(chunk_length, length - chunk_start));
+        const int num_blocks = (n + LOCAL_DATA_ARRAY_LENGTH - 1) / LOCAL_DATA_ARRAY_LENGTH;
+        size_t global_size = num_blocks * local_size;
+
+        // the slot can be refilled once the chunk that used it before has been downloaded
+        err = clEnqueueWriteBuffer(upload_queue, device_in[slot], CL_FALSE, 0, n * sizeof(int), host_in + chunk_start,
+                                   downloaded[slot] ? 1 : 0, downloaded[slot] ? &downloaded[slot] : NULL, &uploaded[slot]);
+        CHECK_CL_ERROR(err, "Couldn't upload the chunk");
+        if (downloaded[slot])
+        {
+            clReleaseEvent(downloaded[slot]);
+            downloaded[slot] = NULL;
+        }
+
+        // set kernel args
+        err = clSetKernelArg(kernel_scan_blocks, 0, sizeof(cl_mem), &device_in[slot]);
+        CHECK_CL_ERROR(err, "Couldn't set arg 1");
+        err = clSetKernelArg(kernel_scan_blocks, 1, sizeof(cl_mem), &device_out[slot]);
+        CHECK_CL_ERROR(err, "Couldn't set arg 2");
+        err = clSetKernelArg(kernel_scan_blocks, 2, sizeof(n), &n);
+        CHECK_CL_ERROR(err, "Couldn't set arg 3");
+        err = clSetKernelArg(kernel_scan_blocks, 3, sizeof(cl_mem), &device_block_sums[slot]);
+        CHECK_CL_ERROR(err, "Couldn't set arg 4");
+
+        err = clSetKernelArg(kernel_scan_block_sums, 0, sizeof(cl_mem), &device_block_sums[slot]);
+        CHECK_CL_ERROR(err, "Couldn't set arg 1");
+        err = clSetKernelArg(kernel_scan_block_sums, 1, sizeof(num_blocks), &num_blocks);
+        CHECK_CL_ERROR(err, "Couldn't set arg 2");
+        err = clSetKernelArg(kernel_scan_block_sums, 2, sizeof(cl_mem), &device_carry);
+        CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+        err = clSetKernelArg(kernel_add_block_offsets, 0, sizeof(cl_mem), &device_out[slot]);
+        CHECK_CL_ERROR(err, "Couldn't set arg 1");
+        err = clSetKernelArg(kernel_add_block_offsets, 1, sizeof(n), &n);
+        CHECK_CL_ERROR(err, "Couldn't set arg 2");
+        err = clSetKernelArg(kernel_add_block_offsets, 2, sizeof(cl_mem), &device_block_sums[slot]);
+        CHECK_CL_ERROR(err, "Couldn't set arg 3");
+
+        // the compute queue is in-order, so the carry of the previous chunk is always ready
+        err = clEnqueueNDRangeKernel(compute_queue, kernel_scan_blocks, 1, NULL, &global_size, &local_size, 1, &uploaded[slot], NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the scanBlocks kernel");
+        err = clEnqueueNDRangeKernel(compute_queue, kernel_scan_block_sums, 1, NULL, &single_group_size, &local_size, 0, NULL, NULL);
+        CHECK_CL_ERROR(err, "Couldn't launch the scanBlockSums kernel");
+        err = clEnqueueNDRangeKernel(compute_queue, kernel_add_block_offsets, 1, NULL, &global_size, &local_size, 0, NULL, &computed[slot]);
+        CHECK_CL_ERROR(err, "Couldn't launch the addBlockOffsets kernel");
+        clReleaseEvent(uploaded[slot]);
+        uploaded[slot] = NULL;
+
+        // the result goes straight into the mapped output file
+        err = clEnqueueReadBuffer(download_queue, device_out[slot], CL_FALSE, 0, n * sizeof(cl_long), host_out + chunk_start,
+                                  1, &computed[slot], &downloaded[slot]);
+        CHECK_CL_ERROR(err, "Couldn't download the chunk");
+        clReleaseEvent(computed[slot]);
+        computed[slot] = NULL;
+
+        // make sure the work is submitted while the host enqueues the next chunk
+        clFlush(upload_queue);
+        clFlush(compute_queue);
+        clFlush(download_queue);
+    }
+
+    // wait until all the chunks are compeletely read from device
+    err = clFinish(download_queue);
+    CHECK_CL_ERROR(err, "Couldn't empty the queue");
+    const auto end_time = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+    const double bytes_moved = static_cast<double>(length) * (sizeof(int) + sizeof(cl_long));
+    std::cout << "Scanned " << length << " elements in " << num_chunks << " chunks of " << chunk_length
+              << " elements: " << seconds << " s, " << bytes_moved / seconds / 1e9 << " GB/s" << std::endl;
+    std::cout << "Total sum: " << host_out[length - 1] << std::endl;
+
+    // Release resources
+    for (int slot = 0; slot < NUM_SLOTS; ++slot)
+    {
+        if (downloaded[slot])
+        {
+            clReleaseEvent(downloaded[slot]);
+        }
+        clReleaseMemObject(device_in[slot]);
+        clReleaseMemObject(device_out[slot]);
+        clReleaseMemObject(device_block_sums[slot]);
+    }
+    clReleaseMemObject(device_carry);
+    clReleaseKernel(kernel_scan_blocks);
+    clReleaseKernel(kernel_scan_block_sums);
+    clReleaseKernel(kernel_add_block_offsets);
+    clReleaseProgram(program);
+    clReleaseCommandQueue(upload_queue);
+    clReleaseCommandQueue(compute_queue);
+    clReleaseCommandQueue(download_queue);
+    clReleaseContext(context);
+
+    // the output is already on disk, unmapping flushes it
+    closeMappedFile(input);
+    closeMappedFile(output);
+
+    return 0;
+}
\ No newline at end of file